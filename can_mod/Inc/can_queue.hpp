@@ -0,0 +1,62 @@
+/**
+ * 单生产者单消费者无锁环形队列
+ * can接收线程投递反馈帧，电机控制线程取出。容量在编译期确定，存储随对象一起预分配，
+ * 运行中不分配内存。队列满时丢弃新帧并返回错误码，由调用方计数。
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <linux/can.h>
+#include "error_struct.hpp"
+
+template <typename T, size_t N>
+class SpscQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+private:
+    T buf[N];
+    alignas(64) std::atomic<size_t> head{0};   //消费者位置
+    alignas(64) std::atomic<size_t> tail{0};   //生产者位置
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 生产者线程
+    ErrorCode push(const T& item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= N)
+            return ErrorCode::QUEUE_FULL;
+        buf[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return ErrorCode::OK;
+    }
+
+    // 消费者线程
+    ErrorCode pop(T& item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return ErrorCode::QUEUE_EMPTY;
+        item = buf[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return ErrorCode::OK;
+    }
+
+    // 先读head再读tail，其它线程并发读取时结果不会下溢
+    size_t size() const
+    {
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_acquire);
+        return t - h;
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+};
+
+template <size_t N = 64>
+using CanFrameQueue = SpscQueue<struct can_frame, N>;
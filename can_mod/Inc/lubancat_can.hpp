@@ -1,3 +1,4 @@
+#pragma once
 #include <iostream>
 #include <string>
 #include <cstring>
@@ -8,8 +9,10 @@
 #include <net/if.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
-#include <vector>
+#include <array>
+#include <initializer_list>
 #include <cstdint>
+#include "error_struct.hpp"
 
 /**
  * @brief A simple C++ wrapper for Linux SocketCAN interface
@@ -20,10 +23,13 @@
  *   can.sendFrame(0x123, {0x11, 0x22, 0x33});
  *
  *   struct can_frame frame;
- *   if (can.recvFrame(frame, 1000)) {
+ *   if (can.recvFrame(frame, 1000) == ErrorCode::OK) {
  *       printf("Got frame: ID=0x%X DLC=%d\n", frame.can_id, frame.can_dlc);
  *   }
  * @endcode
+ *
+ * 发送和接收不分配内存也不抛异常，错误以ErrorCode返回；
+ * 只有构造时打开接口失败会抛异常。
  */
 class CanSocket {
 public:
@@ -46,34 +52,55 @@ public:
         }
     }
 
+    /**
+     * @brief Send a prepared CAN frame
+     * @param frame  Frame with can_id / can_dlc / data filled
+     * @return ErrorCode::OK or ErrorCode::CAN_WRITE_FAILED
+     */
+    ErrorCode sendFrame(const struct can_frame &frame) {
+        ssize_t nbytes = ::write(sock_, &frame, sizeof(frame));
+        if (nbytes != sizeof(frame)) {
+            return ErrorCode::CAN_WRITE_FAILED;
+        }
+        return ErrorCode::OK;
+    }
+
     /**
      * @brief Send a CAN frame
      * @param can_id  CAN ID (11-bit or 29-bit)
-     * @param data    Payload (0~8 bytes)
+     * @param data    Payload pointer
+     * @param len     Payload length (0~8 bytes)
+     * @return ErrorCode::OK, CAN_DLC_INVALID or CAN_WRITE_FAILED
      */
-    void sendFrame(uint32_t can_id, const std::vector<uint8_t> &data) {
-        if (data.size() > 8) {
-            throw std::runtime_error("CAN data > 8 bytes");
+    ErrorCode sendFrame(uint32_t can_id, const uint8_t *data, size_t len) {
+        if (len > CAN_MAX_DLEN) {
+            return ErrorCode::CAN_DLC_INVALID;
         }
 
         struct can_frame frame{};
         frame.can_id = can_id;
-        frame.can_dlc = data.size();
-        std::memcpy(frame.data, data.data(), data.size());
+        frame.can_dlc = static_cast<uint8_t>(len);
+        std::memcpy(frame.data, data, len);
+        return sendFrame(frame);
+    }
 
-        ssize_t nbytes = ::write(sock_, &frame, sizeof(frame));
-        if (nbytes != sizeof(frame)) {
-            throw std::runtime_error("Failed to send CAN frame");
-        }
+    template <size_t N>
+    ErrorCode sendFrame(uint32_t can_id, const std::array<uint8_t, N> &data) {
+        static_assert(N <= CAN_MAX_DLEN, "CAN data > 8 bytes");
+        return sendFrame(can_id, data.data(), N);
+    }
+
+    ErrorCode sendFrame(uint32_t can_id, std::initializer_list<uint8_t> data) {
+        return sendFrame(can_id, data.begin(), data.size());
     }
 
     /**
      * @brief Receive a CAN frame (blocking or with timeout)
      * @param frame_out  Output frame
      * @param timeout_ms Timeout in milliseconds (-1 = blocking forever)
-     * @return true if frame received; false if timeout
+     * @return ErrorCode::OK if frame received; CAN_TIMEOUT if timeout
      */
-    bool recvFrame(struct can_frame &frame_out, int timeout_ms = -1) {
+    ErrorCode recvFrame(struct can_frame &frame_out, int timeout_ms = -1) {
         fd_set readfds;
         FD_ZERO(&readfds);
         FD_SET(sock_, &readfds);
@@ -88,18 +115,18 @@ public:
                            (timeout_ms >= 0 ? &tv : nullptr));
 
         if (ret < 0) {
-            throw std::runtime_error("select() failed");
+            return ErrorCode::CAN_SELECT_FAILED;
         }
         if (ret == 0) {
-            return false;  // timeout
+            return ErrorCode::CAN_TIMEOUT;
         }
 
         ssize_t nbytes = ::read(sock_, &frame_out, sizeof(frame_out));
-        if (nbytes < 0) {
-            throw std::runtime_error("read() failed");
+        if (nbytes != sizeof(frame_out)) {
+            return ErrorCode::CAN_READ_FAILED;
         }
 
-        return true;
+        return ErrorCode::OK;
     }
 
 private:
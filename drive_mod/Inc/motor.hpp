@@ -1,94 +1,122 @@
 #pragma once
 #include <cstring>
 #include <cstdint>
+#include <cmath>
 #include <stdexcept> 
+#include <string>
 #include <iostream>
 #include <linux/can.h>
 #include <PID.hpp>
+#include <alth_mid_data_struct.hpp>
+#include <motor_traits.hpp>
+
+// 电机三个控制器的整套参数，一起发布、一起换入
+struct MotorPID_para
+{
+    PID_para position;
+    PID_para speed_cur;
+    PID_para speed_vol;
+};
 
 /**
  * problem:
  * 1.位置环修改，拓展为自定义位置，增加多圈闭环，支持多圈位置环。位置闭环改为自定义位置。
+ *
+ * 电机通用模板，型号差异（报文ID、编码器、电流范围）全部由Traits在编译期给出，见motor_traits.hpp。
  */
-class GM6020 
+template <typename Traits>
+class Motor
 {
 private:
     uint8_t ID;//电机ID
     uint16_t fb_can_id;//电机反馈报文ID
     uint8_t can_meg_place;//控制can消息位置
     uint16_t ctl_can_id_cur;//电机电流模控制ID
-    uint16_t ctl_can_id_vol;//电机电压模式控制ID
+    uint16_t ctl_can_id_vol = 0;//电机电压模式控制ID，不支持电压控制的型号为0
 
-    int16_t voltage = 0;//设定电压
-    double voltage_provide = 24;//供电电压 -25000 - 25000
+    int16_t voltage = 0;//设定电压 -voltage_max - voltage_max
+    double voltage_provide = 24;//供电电压
     int16_t current = 0;//设定电流
-    int16_t current_fact = 0;//反馈实际电流 -16384 - 16384 -3A - 3A
+    int16_t current_fact = 0;//反馈实际电流 -current_max - current_max
     int16_t angle_last = 0;
-    int16_t angle_fact = 0;//反馈机械角度 0 - 8191
-    int16_t circles = 0;//设定多圈机械角度
-    int16_t circles_fact = 0;//当前实际机械角度
+    int16_t angle_fact = 0;//反馈机械角度 0 - encoder_res
+    int16_t circles = 0;//设定多圈机械角度，int16范围 ±32767 计数，约±4圈，超出的设定点会被限幅
+    int16_t circles_fact = 0;//当前实际多圈机械角度，由反馈累计，范围同上
     int16_t rpm = 0;//设定转速 0- 360 rpm
     int16_t rpm_fact = 0;//反馈速度
     double rpm_pre = 0;//设定转速，算法版本高精度
     double rpm_pre_fact = 0;//由反馈机械角度计算得到的实际转速；
     int circle = 0;//过零检测用圈数
-    int angle2rpm_buf = 0;//过零检测用buf
+    bool fb_first = true;//还没收到过反馈
     /*待解决：丢包导致计算结果不精确问题*/
     uint8_t temp = 0;//反馈温度
 
+    int16_t rpm_ff = 0;//速度前馈，叠加在位置环输出上
+    int16_t current_ff = 0;//电流前馈，叠加在速度环输出上
+    double ff_acc_gain = 0;//加速度前馈增益 电流RAW/(rpm/s)
+
     const int ctl_Hz = 1000;//控制速度
-public:
-    //控制器及其参数
 
-    //PID控制器
+    //PID控制器，参数不走各自的三缓冲，由下面的整套参数在触发链开始时一次换入，
+    //保证同一个周期里位置环和速度环用的是同一次发布的参数
     PIDController<int16_t> position_pid;
     PIDController<int16_t> speed_cur_pid;
     PIDController<int16_t> speed_vol_pid;
-    //参数直接访问控制器修改
+    MotorPID_para pid_staged{};//改参数的线程持有
+    TripleBuffer<MotorPID_para> pid_params;
+
+public:
+    using traits = Traits;
 
-    GM6020(uint8_t ID_, 
+    Motor(uint8_t ID_, 
            PID_para position_pid_para_, PID_para cur_pid_para_, PID_para vol_pid_para_,
            double vol_pro = 24)
         : position_pid(&circles, &circles_fact, &rpm), speed_cur_pid(&rpm, &rpm_fact, &current),speed_vol_pid(&rpm, &rpm_fact, &current)//初始化PID控制器，绑定输入输出节点。
     {
-        if(ID_ > 8 || ID_ < 0)
+        if(ID_ > Traits::id_max || ID_ < Traits::id_min)
         {
-           throw std::runtime_error("unvalid GM6020ID"); //电机id错误
+           throw std::runtime_error(std::string("unvalid ") + Traits::name + " ID"); //电机id错误
         }
 
         ID = ID_;
-        fb_can_id = 0x204 + ID;
+        fb_can_id = Traits::fb_can_id(ID);
+        ctl_can_id_cur = Traits::cur_can_id(ID);
+        if constexpr (Traits::has_voltage)
+            ctl_can_id_vol = Traits::vol_can_id(ID);
+        can_meg_place = Traits::data_place(ID);//写入对应反馈信息
 
-        if(ID == 1 || ID == 2 || ID == 3 || ID == 4)
+        //初始化PID默认参数,传入的参数仅用于默认初始化。运行中改参数用setPidParams整套替换。
+        if (!setPidParams(MotorPID_para{position_pid_para_, cur_pid_para_, vol_pid_para_}))
         {
-            ctl_can_id_vol = 0x1FF;
-            ctl_can_id_cur = 0x1FE;
-            can_meg_place = ID*2;
+            throw std::runtime_error("unvalid PID parameter"); //频率或积分限幅错误
         }
-        else if(ID == 5 || ID == 6 || ID == 7 )
-        {
 
-            ctl_can_id_vol = 0x2FF;
-            ctl_can_id_cur = 0x2FE;
-            can_meg_place = ID*2 - 8;
-        }//写入对应反馈信息
-
-        //初始化PID默认参数,传入的参数仅用于默认初始化。
-        position_pid.setKd(position_pid_para_.Kd); 
-        position_pid.setKi(position_pid_para_.Ki); 
-        position_pid.setKp(position_pid_para_.Kp);
-        speed_cur_pid.setKd(cur_pid_para_.Kd);
-        speed_cur_pid.setKi(cur_pid_para_.Ki);
-        speed_cur_pid.setKp(cur_pid_para_.Kp);
-        speed_vol_pid.setKd(vol_pid_para_.Kd);
-        speed_vol_pid.setKi(vol_pid_para_.Ki);
-        speed_vol_pid.setKp(vol_pid_para_.Kp);
+    }
 
+    //控制器参数，只能在同一个线程调用（一般是CLI或配置线程）
+    //三套一起替换，控制线程下一次触发时一起生效；任一套不合法时整套丢弃并返回false
+    bool setPidParams(const MotorPID_para& para)
+    {
+        if (!pid_para_valid(para.position) || !pid_para_valid(para.speed_cur) || !pid_para_valid(para.speed_vol))
+            return false;
+        pid_staged = para;
+        pid_params.publish(pid_staged);
+        return true;
     }
+    const MotorPID_para& getPidParams() const { return pid_staged; }
+    //控制线程：当前生效的参数
+    const MotorPID_para& activePidParams() const { return pid_params.current(); }
 
     //数据读取
     // 直接读取值
     uint8_t get_ID() const { return ID; }
+    uint16_t get_fb_can_id() const { return fb_can_id; }
+    uint16_t get_ctl_can_id_cur() const { return ctl_can_id_cur; }
+    uint16_t get_ctl_can_id_vol() const
+    {
+        static_assert(Traits::has_voltage, "motor type has no voltage control");
+        return ctl_can_id_vol;
+    }
     int16_t get_voltage() const { return voltage; }
     double get_voltage_pro() const { return voltage_provide; }
     int16_t get_current() const { return current; }
@@ -103,6 +131,8 @@ public:
     double get_rpm_pre_fact() const {return rpm_pre_fact;}
     uint8_t get_temp() const { return temp; }
     int get_circle() const { return circle; }
+    int16_t get_rpm_ff() const { return rpm_ff; }
+    int16_t get_current_ff() const { return current_ff; }
 
     // 外界读取，直接获取地址
     // 兼容性接口，若无法保证电机对象析构后一定不存在对指针的访问，请不要使用该函数获取指针。
@@ -122,35 +152,49 @@ public:
     const uint8_t* get_temp_ptr() const { return &temp; }
     
     //设定数据写入
-    void set_voltage_RAW(int16_t vol){voltage = vol;}
-    void set_voltage_24v(double vol){voltage = static_cast<int>(vol*25000/24);}
-    void set_voltage_percent(double per){voltage = static_cast<int>(per*25000);}
+    //电压接口只对has_voltage的型号可用，成员函数用到才实例化，其它型号调用时编译报错
+    void set_voltage_RAW(int16_t vol)
+    {
+        static_assert(Traits::has_voltage, "motor type has no voltage control");
+        voltage = vol;
+    }
+    void set_voltage_24v(double vol)
+    {
+        static_assert(Traits::has_voltage, "motor type has no voltage control");
+        voltage = static_cast<int>(vol*Traits::voltage_max/24);
+    }
+    void set_voltage_percent(double per)
+    {
+        static_assert(Traits::has_voltage, "motor type has no voltage control");
+        voltage = static_cast<int>(per*Traits::voltage_max);
+    }
     void set_voltage_real(double vol)
     {
+        static_assert(Traits::has_voltage, "motor type has no voltage control");
         if(abs(vol) > voltage_provide)
         {
-            voltage =25000;
+            voltage =Traits::voltage_max;
             return;
         }
-        voltage = static_cast<int>(vol*25000/voltage_provide); 
+        voltage = static_cast<int>(vol*Traits::voltage_max/voltage_provide); 
     }
     void set_voltage_provide(double val){voltage_provide = val;}
 
     void set_current_RAW(int16_t cur){current = cur;}
-    void set_current_percent(double per){current = static_cast<int16_t>(per*16384);}
-    void set_current_real(double real){current = static_cast<int16_t>(real*16384/3);}
+    void set_current_percent(double per){current = static_cast<int16_t>(per*Traits::current_max);}
+    void set_current_real(double real){current = static_cast<int16_t>(real*Traits::current_max/Traits::current_max_A);}
 
     void set_circles_RAW(uint16_t ang){circles = ang;}
-    void set_circles_degree(double cir){circles = static_cast<uint16_t>(cir/360*8191);}
+    void set_circles_degree(double cir){circles = static_cast<uint16_t>(cir/360*Traits::encoder_res);}
 
     void set_circles_fact_RAW(uint16_t ang){circles_fact = ang;}
-    void set_circles_fact_degree(double cir){circles_fact = static_cast<uint16_t>(cir/360*8191);}
+    void set_circles_fact_degree(double cir){circles_fact = static_cast<uint16_t>(cir/360*Traits::encoder_res);}
 
     void set_angle_fact_RAW(uint16_t ang) { angle_fact = ang; }
-    void set_angle_fact_degree(float degree){angle_fact = static_cast<uint16_t>(degree/360*8191);}
-    void set_angle_fact_percent(double per){angle_fact = static_cast<uint16_t>(per*8191);}
+    void set_angle_fact_degree(float degree){angle_fact = static_cast<uint16_t>(degree/360*Traits::encoder_res);}
+    void set_angle_fact_percent(double per){angle_fact = static_cast<uint16_t>(per*Traits::encoder_res);}
 
-    //RPM 一般不直接调用，GM6020以整数形式返回转速，精度不适用于控制，只是适合读取数据
+    //RPM 一般不直接调用，电机以整数形式返回转速，精度不适用于控制，只是适合读取数据
     void set_rpm_RAW(int16_t val){rpm = val;}
     void set_rpm_fact(int16_t val){rpm_fact = val;} 
 
@@ -159,6 +203,31 @@ public:
 
     void set_temp(int8_t val){temp = val;}
 
+    //轨迹设定点写入，位置单位为编码器计数，速度 计数/s，加速度 计数/s^2
+    void set_ff_acc_gain(double gain){ff_acc_gain = gain;}
+    void set_setpoint(const TrajPoint& sp)
+    {
+        circles = sat16(std::lround(sp.pos), 32767);//超出范围限幅，回绕会让位置环反向全速运动
+        rpm_ff = sat16(std::lround(sp.vel*60/Traits::encoder_res), 32767);
+        current_ff = sat16(std::lround(ff_acc_gain*sp.acc*60/Traits::encoder_res), Traits::current_max);
+    }
+
+    //输出清零：电流电压置零，目标位置对齐当前位置，清空控制器状态。
+    //离线或故障时由故障监控每个控制周期调用。
+    void output_zero()
+    {
+        current = 0;
+        voltage = 0;
+        rpm = 0;
+        rpm_pre = 0;
+        rpm_ff = 0;
+        current_ff = 0;
+        circles = circles_fact;
+        position_pid.reset();
+        speed_cur_pid.reset();
+        speed_vol_pid.reset();
+    }
+
     // can报文解码
     int data_set(struct can_frame& fb_frame)
     {
@@ -168,48 +237,58 @@ public:
         angle_fact = (fb_frame.data[0] << 8) | fb_frame.data[1];
         rpm_fact = (fb_frame.data[2] << 8) | fb_frame.data[3];
         current_fact = (fb_frame.data[4] << 8) | fb_frame.data[5];
-        temp = fb_frame.data[6];
-
-        circles_fact += angle_fact - angle_last; 
-        // 计算精确的rpm值&过零检测
+        if constexpr (Traits::has_temp)
+            temp = fb_frame.data[6];
 
-        if (rpm_fact >= 0)
+        // 多圈累计：相邻两帧的角度差折算到±半圈内，跨过零点时圈数加减一
+        constexpr int span = Traits::encoder_res + 1;//一圈的计数
+        if (fb_first)
         {
-            angle2rpm_buf = (angle_fact - angle_last + 8191);
-            if(angle2rpm_buf > 8191)
-            {
-                circle++;
-                rpm_pre_fact = (angle2rpm_buf%8191) / 8191;
-            }
+            fb_first = false;
+            angle_last = angle_fact;
+            circles_fact = angle_fact;//第一帧以单圈角度为起点
         }
-        else if (rpm_fact < 0)
+        int delta = angle_fact - angle_last;
+        if (delta > span / 2)
         {
-            rpm_pre_fact = (angle_last - angle_fact + 8191);
-            if(rpm_pre_fact > 8191)
-            { 
-                circle--;
-                rpm_pre_fact = (angle2rpm_buf%8191) / 8191;
-            }
+            delta -= span;
+            circle--;
+        }
+        else if (delta < -span / 2)
+        {
+            delta += span;
+            circle++;
         }
+        circles_fact = sat16(circles_fact + delta, 32767);
+        rpm_pre_fact = static_cast<double>(delta) * ctl_Hz * 60 / span;//按每个控制周期一帧反馈计算
+        angle_last = angle_fact;
         return 1;
     }
     
-    // can消息打包
+    // can消息打包，控制报文为大端，高字节在前
     int can_data_fill(struct can_frame& send_data)
     {
+        int16_t val;
         if (send_data.can_id == ctl_can_id_cur)
         {
-            memcpy(&send_data.data[can_meg_place], &current, sizeof(current));
+            val = current;
         }
-        else if (send_data.can_id == ctl_can_id_vol)
+        else
         {
-            memcpy(&send_data.data[can_meg_place], &voltage, sizeof(voltage));
-        }
-        else 
-        {
-            return -1;//不是合法的can消息
+            if constexpr (Traits::has_voltage)
+            {
+                if (send_data.can_id != ctl_can_id_vol)
+                    return -1;//不是合法的can消息
+                val = voltage;
+            }
+            else
+            {
+                return -1;//不是合法的can消息
+            }
         }
 
+        send_data.data[can_meg_place] = static_cast<uint16_t>(val) >> 8;
+        send_data.data[can_meg_place + 1] = static_cast<uint16_t>(val) & 0xFF;
         return 0;
     }
 
@@ -218,19 +297,37 @@ public:
     //力矩控制不需要触发控制器链
     inline void speed_cur_trigger()
     {
-        speed_cur_pid.trriger();
+        pid_params.consume();
+        speed_cur_pid.trriger(pid_params.current().speed_cur);
     }
 
     inline void speed_vol_trigger()
     {
-        speed_vol_pid.trriger();
+        static_assert(Traits::has_voltage, "motor type has no voltage control");
+        pid_params.consume();
+        speed_vol_pid.trriger(pid_params.current().speed_vol);
     }
 
+    //位置模式带前馈，前馈默认为0，不使用轨迹时只多了输出限幅
     inline void position_cur_trigger()
     {
-        position_pid.trriger();
-        speed_cur_pid.trriger();
+        pid_params.consume();//两级用同一次发布的参数
+        const MotorPID_para& p = pid_params.current();
+        position_pid.trriger(p.position);
+        rpm = sat16(rpm + rpm_ff, 32767);
+        speed_cur_pid.trriger(p.speed_cur);
+        current = sat16(current + current_ff, Traits::current_max);
     }
 
+private:
+    static int16_t sat16(long val, long lim)
+    {
+        if (val > lim) return lim;
+        if (val < -lim) return -lim;
+        return static_cast<int16_t>(val);
+    }
+};
 
-};
\ No newline at end of file
+using GM6020 = Motor<GM6020Traits>;
+using M3508 = Motor<M3508Traits>;
+using M2006 = Motor<M2006Traits>;
@@ -0,0 +1,54 @@
+/**
+ * 多型号电机组
+ * 同一条can总线上挂不同型号的电机时，用tuple保存各电机引用，反馈分发和控制报文打包
+ * 在编译期展开成对每个电机的直接调用，没有虚函数和运行时类型判断。
+ *
+ * @code
+ *   GM6020 yaw(1, ...);
+ *   M3508 wheel(1, ...);
+ *   MotorGroup group(yaw, wheel);
+ *   group.dispatch(rx_frame);     //接收线程
+ *   group.fill(tx_frame);         //打包控制报文
+ * @endcode
+ *
+ * 注意：GM6020的反馈ID 0x205-0x20B 与 M3508/M2006 ID 5-8 的 0x205-0x208 重叠，
+ * GM6020的电压控制ID 0x1FF 也与 M3508/M2006 ID 5-8 的电流控制ID相同，混用时需要错开ID。
+ */
+#pragma once
+#include <tuple>
+#include <utility>
+#include <linux/can.h>
+#include "motor.hpp"
+
+template <typename... Motors>
+class MotorGroup
+{
+private:
+    std::tuple<Motors&...> motors;
+
+public:
+    explicit MotorGroup(Motors&... motors_) : motors(motors_...) {}
+
+    // 反馈报文交给对应电机解包，返回是否有电机接收
+    bool dispatch(struct can_frame& fb_frame)
+    {
+        return std::apply([&](auto&... m) { return (m.data_set(fb_frame) || ...); }, motors);
+    }
+
+    // 所有控制ID匹配的电机往控制报文里填数据，返回填入的电机数
+    int fill(struct can_frame& send_data)
+    {
+        int n = 0;
+        std::apply([&](auto&... m) { ((n += (m.can_data_fill(send_data) == 0)), ...); }, motors);
+        return n;
+    }
+
+    // 对每个电机调用f，f需要能接受所有型号(泛型lambda)
+    template <typename F>
+    void for_each(F&& f)
+    {
+        std::apply([&](auto&... m) { (f(m), ...); }, motors);
+    }
+
+    static constexpr size_t size() { return sizeof...(Motors); }
+};
@@ -0,0 +1,68 @@
+/**
+ * 电机型号特性
+ * 每个型号一个traits结构体，只放编译期常量和constexpr函数，描述报文ID分配、
+ * 控制报文中的数据位置、编码器分辨率和输出范围。Motor<Traits>按这些常量完成
+ * 解包、打包和控制，不同型号共用同一套代码，没有虚函数。
+ *
+ * 新增型号：照着下面写一个traits，再加一个using别名即可。
+ * 只支持电流控制的型号has_voltage为false，不用写vol_can_id和voltage_max，
+ * 对这类电机调用电压相关接口会在编译期报错。
+ */
+#pragma once
+#include <cstdint>
+
+// GM6020 云台电机，反馈0x204+ID，ID 1-7，支持电压和电流控制
+struct GM6020Traits
+{
+    static constexpr const char* name = "GM6020";
+    static constexpr uint8_t id_min = 1;
+    static constexpr uint8_t id_max = 7;
+
+    static constexpr uint16_t fb_can_id(uint8_t id) { return 0x204 + id; }
+    static constexpr uint16_t cur_can_id(uint8_t id) { return id <= 4 ? 0x1FE : 0x2FE; }
+    static constexpr bool has_voltage = true;
+    static constexpr uint16_t vol_can_id(uint8_t id) { return id <= 4 ? 0x1FF : 0x2FF; }
+    static constexpr uint8_t data_place(uint8_t id) { return (id - 1) % 4 * 2; }//控制报文中的字节偏移
+
+    static constexpr int encoder_res = 8191;    //编码器 0 - 8191
+    static constexpr int16_t current_max = 16384;//电流给定 -16384 - 16384
+    static constexpr double current_max_A = 3.0; //对应 -3A - 3A
+    static constexpr int16_t voltage_max = 25000;//电压给定 -25000 - 25000
+    static constexpr bool has_temp = true;
+};
+
+// M3508 + C620电调，反馈0x200+ID，ID 1-8，仅电流控制
+struct M3508Traits
+{
+    static constexpr const char* name = "M3508";
+    static constexpr uint8_t id_min = 1;
+    static constexpr uint8_t id_max = 8;
+
+    static constexpr uint16_t fb_can_id(uint8_t id) { return 0x200 + id; }
+    static constexpr uint16_t cur_can_id(uint8_t id) { return id <= 4 ? 0x200 : 0x1FF; }
+    static constexpr bool has_voltage = false;
+    static constexpr uint8_t data_place(uint8_t id) { return (id - 1) % 4 * 2; }
+
+    static constexpr int encoder_res = 8191;
+    static constexpr int16_t current_max = 16384;//-20A - 20A
+    static constexpr double current_max_A = 20.0;
+    static constexpr bool has_temp = true;
+};
+
+// M2006 + C610电调，反馈0x200+ID，ID 1-8，仅电流控制，不反馈温度
+struct M2006Traits
+{
+    static constexpr const char* name = "M2006";
+    static constexpr uint8_t id_min = 1;
+    static constexpr uint8_t id_max = 8;
+
+    static constexpr uint16_t fb_can_id(uint8_t id) { return 0x200 + id; }
+    static constexpr uint16_t cur_can_id(uint8_t id) { return id <= 4 ? 0x200 : 0x1FF; }
+    static constexpr bool has_voltage = false;
+    static constexpr uint8_t data_place(uint8_t id) { return (id - 1) % 4 * 2; }
+
+    static constexpr int encoder_res = 8191;
+    static constexpr int16_t current_max = 10000;//-10A - 10A
+    static constexpr double current_max_A = 10.0;
+    static constexpr bool has_temp = false;
+};
@@ -0,0 +1,51 @@
+/**
+ * 定长对象池
+ * 启动阶段原地构造对象，之后地址不再变化。电机对象内部的PID控制器绑定了成员地址，
+ * 不能拷贝或移动，放进std::vector扩容后指针会失效，所以用这个池子统一存放。
+ */
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "error_struct.hpp"
+
+template <typename T, size_t N>
+class StaticArena
+{
+private:
+    alignas(T) unsigned char storage[N][sizeof(T)];
+    size_t count = 0;
+
+public:
+    StaticArena() = default;
+    StaticArena(const StaticArena&) = delete;
+    StaticArena& operator=(const StaticArena&) = delete;
+
+    ~StaticArena()
+    {
+        while (count > 0)
+            (*this)[--count].~T();
+    }
+
+    // 原地构造，池满时返回ARENA_FULL，构造函数抛出的异常原样传出
+    template <typename... Args>
+    ErrorCode emplace(T** out, Args&&... args)
+    {
+        if (count >= N)
+            return ErrorCode::ARENA_FULL;
+        T* obj = new (storage[count]) T(std::forward<Args>(args)...);
+        count++;
+        if (out)
+            *out = obj;
+        return ErrorCode::OK;
+    }
+
+    T& operator[](size_t i) { return *std::launder(reinterpret_cast<T*>(storage[i])); }
+    const T& operator[](size_t i) const { return *std::launder(reinterpret_cast<const T*>(storage[i])); }
+
+    T* begin() { return count ? &(*this)[0] : nullptr; }
+    T* end() { return count ? &(*this)[0] + count : nullptr; }
+
+    size_t size() const { return count; }
+    static constexpr size_t capacity() { return N; }
+};
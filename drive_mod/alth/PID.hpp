@@ -1,18 +1,45 @@
 /**
  * 使用过程中发现的问题：
  * PID参数不便于修改 ： 改为外置结构体传入
- * 输入输出参数不一致时无法使用 
+ * 输入输出参数不一致时无法使用
+ * 运行中从别的线程改参数有数据竞争 ： 参数整套放进三缓冲，控制线程在trriger开始时换入
+ * 串级控制器各自换入会在同一周期混用新外环、旧内环 ： trriger(para)由调用方给参数，
+ *     电机把三个控制器的参数放进同一个三缓冲，一次换入（见motor.hpp）
  */
 #pragma once
 #include <type_traits>
+#include <limits>
+#include <cmath>
+#include "param_buffer.hpp"
 
 struct PID_para
 {
     double Kp;
     double Ki;
-    double Kd;    
+    double Kd;
+
+    // 积分限幅
+    double integral_min = 0;
+    double integral_max = 0;
+    bool use_integral_limit = false;
+
+    // 控制频率 (Hz)
+    int frequency = 1000;
 };
 
+// 参数合法性：数值有限，频率为正，启用积分限幅时下限不大于上限
+inline bool pid_para_valid(const PID_para& p)
+{
+    if (!std::isfinite(p.Kp) || !std::isfinite(p.Ki) || !std::isfinite(p.Kd))
+        return false;
+    if (p.frequency <= 0)
+        return false;
+    if (p.use_integral_limit &&
+        !(std::isfinite(p.integral_min) && std::isfinite(p.integral_max) && p.integral_min <= p.integral_max))
+        return false;
+    return true;
+}
+
 template <typename T>
 class PIDController {
     static_assert(std::is_arithmetic<T>::value, "T must be a numeric type");
@@ -23,77 +50,103 @@ private:
     T* current_value;  //当前值
     T* output;         // 输出
 
-    // PID 参数
-    double Kp = 0;
-    double Ki = 0;
-    double Kd = 0;
+    // PID 参数：staged由改参数的线程持有，params由控制线程在周期边界换入
+    PID_para staged{0, 0, 0};
+    TripleBuffer<PID_para> params;
 
-    // 控制频率 (Hz)
-    int frequency = 1000;   
-    double dt = 1.0 / frequency;
     // 内部状态
-    T previous_error = 0;
-    T integral = 0;
+    double previous_error = 0;
+    double integral = 0;
 
-    // 积分限幅
-    T integral_min = 0;
-    T integral_max = 0;
-    bool use_integral_limit = false;
+    void publish() { params.publish(staged); }
 
 public:
 
     // 构造函数
     PIDController(T* setpoint,T* current_value,T* output)
-        : setpoint(setpoint), current_value(current_value), output(output) {}
+        : setpoint(setpoint), current_value(current_value), output(output), params(staged) {}
+
+    // 参数访问，只能在同一个线程调用（一般是CLI或配置线程）
+    // 整套替换，控制线程下一次trriger时一次性生效
+    // 参数不合法（见pid_para_valid）时整套丢弃并返回false，setFrequency/setIntegralLimit同样处理
+    static bool valid(const PID_para& para) { return pid_para_valid(para); }
+
+    bool setParams(const PID_para& para) {
+        if (!valid(para)) return false;
+        staged = para;
+        publish();
+        return true;
+    }
+    const PID_para& getParams() const { return staged; }
 
-    // 参数访问
-    void setKp(double value) { Kp = value; }
-    void setKi(double value) { Ki = value; }
-    void setKd(double value) { Kd = value; }
+    // 单项修改，每次调用单独生效，需要同时改多项时用setParams
+    void setKp(double value) { staged.Kp = value; publish(); }
+    void setKi(double value) { staged.Ki = value; publish(); }
+    void setKd(double value) { staged.Kd = value; publish(); }
 
-    double getKp() const { return Kp; }
-    double getKi() const { return Ki; }
-    double getKd() const { return Kd; }
+    double getKp() const { return staged.Kp; }
+    double getKi() const { return staged.Ki; }
+    double getKd() const { return staged.Kd; }
 
     // 频率访问
-    void setFrequency(T hz) { 
-        if (hz > 0) frequency = hz; 
+    bool setFrequency(int hz) {
+        PID_para para = staged;
+        para.frequency = hz;
+        return setParams(para);
     }
-    T getFrequency() const { return frequency; }
-    T getDt() const { return 1.0 / frequency; }
+    int getFrequency() const { return staged.frequency; }
+    double getDt() const { return 1.0 / staged.frequency; }
+
+    // 积分限幅
+    bool setIntegralLimit(double min_val, double max_val) {
+        PID_para para = staged;
+        para.integral_min = min_val;
+        para.integral_max = max_val;
+        para.use_integral_limit = true;
+        return setParams(para);
+    }
+
+    // 控制线程：当前生效的参数
+    const PID_para& activeParams() const { return params.current(); }
 
     // 状态访问
     void reset() {
         previous_error = 0;
         integral = 0;
     }
-    T getError() const { return setpoint - current_value; }
-    T getIntegral() const { return integral; }
+    T getError() const { return *setpoint - *current_value; }
+    T getIntegral() const { return static_cast<T>(integral); }
 
-    // 积分限幅
-    void setIntegralLimit(T min_val, T max_val) {
-        integral_min = min_val;
-        integral_max = max_val;
-        use_integral_limit = true;
+    // PID计算，周期边界换入自己三缓冲里的新参数
+    void trriger() {
+        params.consume();
+        trriger(params.current());
     }
 
-    // PID计算 
-    void trriger() {
+    // PID计算，参数由调用方给出，不读自己的三缓冲
+    // 用于几个控制器的参数必须同一周期一起生效的场合，p需已通过pid_para_valid
+    void trriger(const PID_para& p) {
+        const double dt = 1.0 / p.frequency;
 
-        T error = setpoint - current_value;
+        double error = static_cast<double>(*setpoint) - static_cast<double>(*current_value);
 
         // 积分
         integral += error * dt;
-        if (use_integral_limit) {
-            if (integral > integral_max) integral = integral_max;
-            if (integral < integral_min) integral = integral_min;
+        if (p.use_integral_limit) {
+            if (integral > p.integral_max) integral = p.integral_max;
+            if (integral < p.integral_min) integral = p.integral_min;
         }
 
         // 微分
-        T derivative = (error - previous_error) / dt;
+        double derivative = (error - previous_error) / dt;
 
         // 输出计算
-        *output = Kp * error + Ki * integral + Kd * derivative;
+        double out = p.Kp * error + p.Ki * integral + p.Kd * derivative;
+        if (std::is_integral<T>::value) {
+            if (out > std::numeric_limits<T>::max()) out = std::numeric_limits<T>::max();
+            if (out < std::numeric_limits<T>::lowest()) out = std::numeric_limits<T>::lowest();
+        }
+        *output = static_cast<T>(out);
 
         // 更新状态
         previous_error = error;
@@ -1,2 +1,10 @@
+#pragma once
 #include <type_traits>
 
+// 轨迹设定点：位置、速度前馈、加速度前馈，单位由轨迹发生器的使用者决定
+struct TrajPoint
+{
+    double pos = 0;
+    double vel = 0;
+    double acc = 0;
+};
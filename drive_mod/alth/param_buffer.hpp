@@ -0,0 +1,52 @@
+/**
+ * 参数三缓冲
+ * 一个写线程发布整套参数，控制线程在周期开始时取最新一套，双方都不加锁也不等待。
+ * 写线程写后缓冲再和中间缓冲交换，控制线程只在中间缓冲有新数据时和前缓冲交换，
+ * 所以控制线程拿到的永远是某一次publish写入的完整参数，不会混出半新半旧的组合。
+ *
+ * 只支持一个写线程，多个地方改参数时由调用方串行化。
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+template <typename T>
+class TripleBuffer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+private:
+    static constexpr uint8_t DIRTY = 0x4;
+    static constexpr uint8_t INDEX = 0x3;
+
+    T buf[3];
+    std::atomic<uint8_t> middle{1};     //中间缓冲下标，DIRTY表示有未取走的新数据
+    uint8_t back = 0;                   //写线程独占
+    uint8_t front = 2;                  //控制线程独占
+
+public:
+    explicit TripleBuffer(const T& init = T()) : buf{init, init, init} {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // 写线程：发布一套新参数，未被取走的旧发布会被覆盖
+    void publish(const T& value)
+    {
+        buf[back] = value;
+        back = middle.exchange(back | DIRTY, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // 控制线程：有新参数时换入并返回true
+    bool consume()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & DIRTY))
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // 控制线程：当前生效的参数
+    const T& current() const { return buf[front]; }
+};
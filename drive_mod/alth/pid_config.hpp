@@ -0,0 +1,148 @@
+/**
+ * PID参数配置文件
+ * 启动时读取，也可以在配置线程里重新读取后pid_config_apply，控制线程不受影响。
+ * 读取过程会分配内存，出错抛异常，不要在控制线程里调用。
+ *
+ * 文件格式，#开头为注释，每节一套参数，节名自定：
+ * @code
+ *   [yaw.position]
+ *   Kp = 1.2
+ *   Ki = 0
+ *   Kd = 0.01
+ *   integral_min = -500      # 写了上下限就启用积分限幅
+ *   integral_max = 500
+ *   frequency = 1000
+ * @endcode
+ */
+#pragma once
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <istream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "PID.hpp"
+
+using PidConfig = std::map<std::string, PID_para>;
+
+namespace pid_config_detail
+{
+inline std::string trim(const std::string& s)
+{
+    size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos)
+        return "";
+    size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+inline double to_double(const std::string& val, const std::string& where)
+{
+    size_t used = 0;
+    double d = 0;
+    try {
+        d = std::stod(val, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used != val.size() || !std::isfinite(d))
+        throw std::runtime_error(where + ": bad number '" + val + "'");
+    return d;
+}
+}
+
+inline PidConfig pid_config_parse(std::istream& in, const std::string& source = "<stream>")
+{
+    using namespace pid_config_detail;
+
+    PidConfig cfg;
+    PID_para* cur = nullptr;
+    std::string line;
+    int lineno = 0;
+
+    while (std::getline(in, line))
+    {
+        lineno++;
+        std::string where = source + ":" + std::to_string(lineno);
+
+        size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.erase(hash);
+        line = trim(line);
+        if (line.empty())
+            continue;
+
+        if (line.front() == '[')
+        {
+            if (line.back() != ']')
+                throw std::runtime_error(where + ": missing ']'");
+            std::string name = trim(line.substr(1, line.size() - 2));
+            if (name.empty())
+                throw std::runtime_error(where + ": empty section name");
+            if (cfg.count(name))
+                throw std::runtime_error(where + ": duplicate section [" + name + "]");
+            cur = &cfg[name];
+            *cur = PID_para{0, 0, 0};
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            throw std::runtime_error(where + ": expected 'key = value'");
+        if (!cur)
+            throw std::runtime_error(where + ": key outside of section");
+
+        std::string key = trim(line.substr(0, eq));
+        double val = to_double(trim(line.substr(eq + 1)), where);
+
+        if (key == "Kp") cur->Kp = val;
+        else if (key == "Ki") cur->Ki = val;
+        else if (key == "Kd") cur->Kd = val;
+        else if (key == "integral_min") { cur->integral_min = val; cur->use_integral_limit = true; }
+        else if (key == "integral_max") { cur->integral_max = val; cur->use_integral_limit = true; }
+        else if (key == "frequency")
+        {
+            if (val < 1 || val != std::floor(val) || val > std::numeric_limits<int>::max())
+                throw std::runtime_error(where + ": frequency must be a positive integer");
+            cur->frequency = static_cast<int>(val);
+        }
+        else
+            throw std::runtime_error(where + ": unknown key '" + key + "'");
+    }
+
+    for (const auto& kv : cfg)
+    {
+        const PID_para& p = kv.second;
+        if (p.use_integral_limit && p.integral_min > p.integral_max)
+            throw std::runtime_error(source + ": [" + kv.first + "] integral_min > integral_max");
+    }
+    return cfg;
+}
+
+inline PidConfig pid_config_load(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open PID config: " + path);
+    return pid_config_parse(in, path);
+}
+
+// 按节名给电机的三个控制器赋值：name.position / name.speed_cur / name.speed_vol，缺的节保持不变
+// 三套一起发布，控制线程同一周期换入；参数不合法时电机参数不变并返回false
+template <typename MotorT>
+bool pid_config_apply(MotorT& motor, const PidConfig& cfg, const std::string& name)
+{
+    auto para = motor.getPidParams();
+    auto it = cfg.find(name + ".position");
+    if (it != cfg.end())
+        para.position = it->second;
+    it = cfg.find(name + ".speed_cur");
+    if (it != cfg.end())
+        para.speed_cur = it->second;
+    it = cfg.find(name + ".speed_vol");
+    if (it != cfg.end())
+        para.speed_vol = it->second;
+    return motor.setPidParams(para);
+}
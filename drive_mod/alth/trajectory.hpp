@@ -0,0 +1,186 @@
+/**
+ * 在线轨迹发生器
+ * 位置环直接跳到目标会让速度环饱和、电流冲击，这里把目标位置转成每个控制周期的设定点。
+ *
+ * 梯形：按离散制动曲线在线计算期望速度，每个周期速度变化不超过 a_max*dt，
+ *       不预先规划整段轨迹，所以随时可以改目标，运动中改目标也是连续的。
+ * S曲线：梯形输出的速度再过一个长度为 a_max/(j_max*dt) 的滑动平均，
+ *       得到加速度连续、加加速度受限的轨迹，终点位置不变，整体延迟一个窗口。
+ *       短行程时加速段和减速段会同时落在窗口内，瞬时加加速度最多到2倍j_max。
+ *
+ * 每个周期O(1)，窗口缓冲按模板参数定长，不分配内存。每个电机一个对象。
+ */
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "alth_mid_data_struct.hpp"
+
+enum class ProfileType : uint8_t
+{
+    TRAPEZOID = 0,
+    S_CURVE,
+};
+
+struct TrajLimit
+{
+    double v_max = 0;   //最大速度
+    double a_max = 0;   //最大加速度
+    double j_max = 0;   //最大加加速度，仅S曲线使用
+};
+
+template <size_t MaxWindow = 256>
+class TrajectoryGenerator
+{
+    static_assert(MaxWindow >= 1, "MaxWindow must be positive");
+
+private:
+    ProfileType type = ProfileType::TRAPEZOID;
+    TrajLimit limit;
+    double dt = 1.0 / 1000;
+
+    double target_pos = 0;
+
+    // 梯形内核状态
+    double p = 0;
+    double v = 0;
+
+    // S曲线滑动平均窗口
+    double window[MaxWindow] = {};
+    size_t win_len = 1;
+    size_t win_idx = 0;
+    double win_sum = 0;
+    size_t settled = 0;     //梯形内核已静止的周期数
+
+    TrajPoint out;
+
+public:
+    TrajectoryGenerator() = default;
+
+    // 配置参数，启动时调用，之后需要reset
+    void config(ProfileType type_, const TrajLimit& limit_, int frequency = 1000)
+    {
+        type = type_;
+        limit = limit_;
+        if (frequency > 0)
+            dt = 1.0 / frequency;
+
+        win_len = 1;
+        if (type == ProfileType::S_CURVE && limit.j_max > 0)
+        {
+            double n = std::ceil(limit.a_max / (limit.j_max * dt));
+            if (n > static_cast<double>(MaxWindow))
+                n = static_cast<double>(MaxWindow);//窗口不够长时加加速度会超过设定值
+            if (n > 1)
+                win_len = static_cast<size_t>(n);
+        }
+        reset(out.pos);
+    }
+
+    // 以静止状态停在pos，上电或故障恢复后用电机当前位置调用
+    // 恢复时机由FaultMonitor::take_resumed()给出，见fault_monitor.hpp
+    void reset(double pos)
+    {
+        target_pos = pos;
+        p = pos;
+        v = 0;
+        for (size_t i = 0; i < win_len; i++)
+            window[i] = 0;
+        win_idx = 0;
+        win_sum = 0;
+        settled = win_len + 1;
+        out = TrajPoint();
+        out.pos = pos;
+    }
+
+    // 设置新目标，运动中也可以调用
+    void set_target(double pos)
+    {
+        target_pos = pos;
+        settled = 0;
+    }
+
+    // 推进一个控制周期
+    const TrajPoint& step()
+    {
+        if (settled > win_len)
+            return out;
+
+        const double a_step = limit.a_max * dt;
+        const double d = target_pos - p;
+        const double v_old = v;
+
+        // 离散制动曲线：速度序列 v, v-a_step, ..., r, 0 恰好走完剩余距离时的最大v，
+        // m为整步数，r为最后不足一步的余量。沿曲线减速时每步刚好减a_step，最后一步正好落在目标上
+        double v_brake = 0;
+        if (a_step > 0)
+        {
+            double m = std::floor(-0.5 + std::sqrt(0.25 + 2 * std::fabs(d) / (a_step * dt)));
+            if (m < 0)
+                m = 0;
+            double r = (std::fabs(d) / dt - a_step * m * (m + 1) / 2) / (m + 1);
+            v_brake = m * a_step + r;
+        }
+        if (v_brake > limit.v_max)
+            v_brake = limit.v_max;
+        double v_des = d >= 0 ? v_brake : -v_brake;
+
+        if (v_des > v + a_step) v_des = v + a_step;
+        if (v_des < v - a_step) v_des = v - a_step;
+
+        // 最后一步不越过目标
+        bool land = false;
+        if ((d >= 0 && v_des * dt > d) || (d < 0 && v_des * dt < d))
+        {
+            v_des = d / dt;
+            land = true;
+        }
+
+        v = v_des;
+        if (land)
+            p = target_pos;
+        else
+            p += v * dt;
+
+        if (p == target_pos && v == 0)
+            settled++;
+        else
+            settled = 0;
+
+        if (win_len == 1)
+        {
+            out.acc = (v - v_old) / dt;
+            out.vel = v;
+            out.pos = p;
+        }
+        else
+        {
+            double v_in = v;
+            double v_out = window[win_idx];
+            window[win_idx] = v_in;
+            win_idx = (win_idx + 1) % win_len;
+            win_sum += v_in - v_out;
+
+            out.acc = (v_in - v_out) / (win_len * dt);
+            out.vel = win_sum / win_len;
+            out.pos += out.vel * dt;
+        }
+
+        // 静止超过一个窗口，最后一个非零速度也已移出，消除累计误差
+        if (settled > win_len)
+        {
+            for (size_t i = 0; i < win_len; i++)
+                window[i] = 0;
+            win_sum = 0;
+            out.pos = target_pos;
+            out.vel = 0;
+            out.acc = 0;
+        }
+        return out;
+    }
+
+    const TrajPoint& point() const { return out; }
+    double target() const { return target_pos; }
+    bool done() const { return settled > win_len; }
+    size_t window_len() const { return win_len; }
+};
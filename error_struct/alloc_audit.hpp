@@ -0,0 +1,137 @@
+/**
+ * 堆分配审计
+ * 启动完成后控制、接收、发送路径都不应该再分配内存。审计模式下替换全局operator new，
+ * 在AllocAudit::Scope有效期间发生的任何分配都会打印并abort，让测试直接失败。
+ * Scope按线程生效，只检查打开它的线程，CLI等其它线程照常分配不受影响。
+ *
+ * 用法：只在一个cpp里先定义 ALLOC_AUDIT_HOOKS 再包含本头文件，
+ *       其它文件直接包含即可使用Scope。
+ * @code
+ *   #define ALLOC_AUDIT_HOOKS
+ *   #include "alloc_audit.hpp"
+ *   ...
+ *   {
+ *       AllocAudit::Scope audit;   //进入控制循环
+ *       loop_once();
+ *   }
+ * @endcode
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+
+struct AllocAudit
+{
+    static inline thread_local int depth = 0;  //本线程打开的Scope层数
+    static inline std::atomic<size_t> violations{0};
+    static inline bool fatal = true;    //false时只计数，不abort
+
+    class Scope
+    {
+    public:
+        Scope() { depth++; }
+        ~Scope() { depth--; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // 在operator new里调用，不能再分配内存，只用write
+    static void check(size_t)
+    {
+        if (depth == 0)
+            return;
+        violations.fetch_add(1, std::memory_order_relaxed);
+        if (fatal)
+        {
+            static const char msg[] = "[ALLOC_AUDIT] heap allocation inside audited loop\n";
+            (void)::write(2, msg, sizeof(msg) - 1);
+            std::abort();
+        }
+    }
+};
+
+#ifdef ALLOC_AUDIT_HOOKS
+void* operator new(size_t size)
+{
+    AllocAudit::check(size);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    AllocAudit::check(size);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    AllocAudit::check(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    AllocAudit::check(size);
+    return std::malloc(size ? size : 1);
+}
+
+// 对齐分配，alignas超过默认对齐的类型(如SpscQueue)走这里
+inline void* alloc_audit_aligned(size_t size, std::align_val_t al) noexcept
+{
+    void* p = nullptr;
+    size_t align = static_cast<size_t>(al);
+    if (align < sizeof(void*))
+        align = sizeof(void*);
+    if (::posix_memalign(&p, align, size ? size : 1) != 0)
+        return nullptr;
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t al)
+{
+    AllocAudit::check(size);
+    if (void* p = alloc_audit_aligned(size, al))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t al)
+{
+    AllocAudit::check(size);
+    if (void* p = alloc_audit_aligned(size, al))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    AllocAudit::check(size);
+    return alloc_audit_aligned(size, al);
+}
+
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    AllocAudit::check(size);
+    return alloc_audit_aligned(size, al);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,67 @@
+/**
+ * 错误码定义
+ * 运行中的故障不抛异常，统一用错误码 + 故障记录上报，由故障状态机处理。
+ * 异常只保留给初始化阶段的配置错误。
+ */
+#pragma once
+#include <cstdint>
+
+enum class ErrorCode : uint16_t
+{
+    OK = 0,
+
+    // 电机故障
+    MOTOR_OFFLINE = 0x0100,      //心跳超时，电机离线
+    MOTOR_OVER_TEMP = 0x0101,    //温度超限
+    MOTOR_CUR_SATURATED = 0x0102,//电流持续饱和
+
+    // 监控器自身错误
+    MONITOR_FULL = 0x0200,       //监控槽位已满
+    MONITOR_BAD_SLOT = 0x0201,   //槽位不存在
+    TIMERFD_FAILED = 0x0202,     //timerfd创建或设置失败
+    EPOLL_FAILED = 0x0203,       //epoll创建或等待失败
+
+    // can接口错误
+    CAN_DLC_INVALID = 0x0300,    //数据长度超过8字节
+    CAN_WRITE_FAILED = 0x0301,   //发送失败
+    CAN_READ_FAILED = 0x0302,    //接收失败
+    CAN_SELECT_FAILED = 0x0303,  //select等待失败
+    CAN_TIMEOUT = 0x0304,        //接收超时
+
+    // 预分配资源
+    QUEUE_FULL = 0x0400,         //消息队列已满，帧被丢弃
+    QUEUE_EMPTY = 0x0401,        //消息队列为空
+    ARENA_FULL = 0x0402,         //内存池已满
+};
+
+inline const char* error_str(ErrorCode code)
+{
+    switch (code)
+    {
+    case ErrorCode::OK: return "ok";
+    case ErrorCode::MOTOR_OFFLINE: return "motor offline";
+    case ErrorCode::MOTOR_OVER_TEMP: return "motor over temperature";
+    case ErrorCode::MOTOR_CUR_SATURATED: return "motor current saturated";
+    case ErrorCode::MONITOR_FULL: return "monitor full";
+    case ErrorCode::MONITOR_BAD_SLOT: return "monitor bad slot";
+    case ErrorCode::TIMERFD_FAILED: return "timerfd failed";
+    case ErrorCode::EPOLL_FAILED: return "epoll failed";
+    case ErrorCode::CAN_DLC_INVALID: return "CAN data > 8 bytes";
+    case ErrorCode::CAN_WRITE_FAILED: return "Failed to send CAN frame";
+    case ErrorCode::CAN_READ_FAILED: return "read() failed";
+    case ErrorCode::CAN_SELECT_FAILED: return "select() failed";
+    case ErrorCode::CAN_TIMEOUT: return "CAN receive timeout";
+    case ErrorCode::QUEUE_FULL: return "queue full";
+    case ErrorCode::QUEUE_EMPTY: return "queue empty";
+    case ErrorCode::ARENA_FULL: return "arena full";
+    }
+    return "unknown error";
+}
+
+// 故障记录
+struct FaultInfo
+{
+    ErrorCode code = ErrorCode::OK;
+    uint8_t motor_id = 0;   //出错电机ID
+    int32_t value = 0;      //触发时的数值：温度/电流/超时次数
+};
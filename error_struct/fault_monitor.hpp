@@ -0,0 +1,363 @@
+/**
+ * 电机在线检测与故障状态机
+ *
+ * 心跳：每个电机一个单次触发的timerfd，收到反馈帧就重新装填，超时由内核负责，
+ *       所有timerfd挂在同一个epoll上，控制线程每个周期非阻塞取一次到期事件。
+ * 故障：过温、电流持续饱和，锁存直到手动clear。故障期间心跳超时只记离线标志，
+ *       不改变状态也不覆盖锁存的故障，反馈恢复后仍保持FAULT。
+ * 输出：离线或故障的电机在tick()里直接把输出清零，tick()放在控制器触发之后、
+ *       can消息打包之前调用，保证一个控制周期内输出归零。
+ * 恢复：重新上线时设定位置对齐到当前位置，但上层的轨迹发生器还停在旧的设定点，
+ *       控制线程每个周期用take_resumed()检查，为真时先traj.reset(motor.get_circles_fact())
+ *       再写设定点，否则下一次set_setpoint会把旧轨迹点写回去。
+ *
+ * 型号：一个监控器可以同时管理不同型号的电机，模板参数列出用到的型号。
+ *       每种型号一张定长表存该型号的电机指针，tick()用折叠表达式逐表展开（同MotorGroup::for_each），
+ *       循环体里是具体类型，没有虚函数也没有运行期按型号分支；饱和阈值按各自型号的
+ *       满量程在attach时算好存在槽位里。不写型号时默认只管GM6020。
+ *
+ * 线程划分：
+ * on_frame() 在can接收线程调用，只重装timerfd和置位标志；
+ * tick()/clear()/state()/fault() 在控制线程调用。
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <atomic>
+#include <type_traits>
+#include <tuple>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <linux/can.h>
+#include "motor.hpp"
+#include "motor_group.hpp"
+#include "error_struct.hpp"
+
+struct FaultLimit
+{
+    uint32_t heartbeat_ms = 20;        //反馈超时时间，电调反馈频率1kHz
+    uint8_t temp_max = 70;             //过温阈值(℃)
+    uint8_t temp_recover = 60;         //低于该温度才允许清除过温故障
+    double cur_saturation = 0.97;      //饱和判定电流，占该型号满量程的比例
+    uint16_t cur_saturation_ticks = 500;//连续饱和多少个控制周期判定故障
+};
+
+enum class MotorState : uint8_t
+{
+    OFFLINE = 0,    //未收到反馈或心跳超时
+    ONLINE,         //正常
+    FAULT,          //故障锁存
+};
+
+namespace fault_monitor_detail
+{
+// 一种型号的电机表，slot为在监控器里的槽位号
+template <typename MotorT, size_t N>
+struct typed_slots
+{
+    MotorT* motor[N] = {};
+    size_t slot[N] = {};
+    size_t count = 0;
+};
+
+template <size_t N, typename... Motors>
+struct slot_tables { using type = std::tuple<typed_slots<Motors, N>...>; };
+
+template <size_t N>
+struct slot_tables<N> { using type = std::tuple<typed_slots<GM6020, N>>; };
+
+template <typename T, typename Tuple>
+struct has_table;
+
+template <typename T, typename... Ts>
+struct has_table<T, std::tuple<Ts...>> : std::disjunction<std::is_same<T, Ts>...> {};
+}
+
+// Motors为要管理的电机型号，可以混用
+template <size_t N = 7, typename... Motors>
+class FaultMonitor
+{
+private:
+    using Tables = typename fault_monitor_detail::slot_tables<N, Motors...>::type;
+
+    struct Slot
+    {
+        int tfd = -1;                   //心跳timerfd
+        std::atomic<bool> fed{false};   //收到过新反馈
+        MotorState state = MotorState::OFFLINE;
+        bool offline = true;            //心跳超时，和state分开记，故障锁存期间也要知道
+        bool resumed = false;           //刚回到ONLINE，等控制线程取走
+        FaultInfo fault;                //最近一次故障
+        uint16_t sat_ticks = 0;         //连续饱和计数
+        int cur_sat_raw = 0;            //饱和阈值，换算成该型号的电流RAW值
+        uint16_t fb_can_id = 0;
+        uint8_t motor_id = 0;
+    };
+
+    Slot slots[N];
+    Tables tables;
+    size_t count = 0;
+    int epfd = -1;
+    FaultLimit limit;
+    ErrorCode init_err = ErrorCode::OK;
+
+    template <typename F>
+    void for_each_table(F&& f)
+    {
+        std::apply([&](auto&... t) { (f(t), ...); }, tables);
+    }
+
+    // 按槽位找电机，逐表线性查找，只给clear这类低频接口用
+    template <typename F>
+    void with_motor(size_t slot, F&& f)
+    {
+        for_each_table([&](auto& t) {
+            for (size_t k = 0; k < t.count; k++)
+            {
+                if (t.slot[k] == slot)
+                    f(*t.motor[k]);
+            }
+        });
+    }
+
+    void enter(Slot& s, MotorState st, ErrorCode code, int32_t value)
+    {
+        s.state = st;
+        s.fault.code = code;
+        s.fault.motor_id = s.motor_id;
+        s.fault.value = value;
+        s.sat_ticks = 0;
+    }
+
+    // 单个电机的状态机，MotorT为具体型号
+    template <typename MotorT>
+    void check(Slot& s, MotorT& m, ErrorCode& ret)
+    {
+        bool fed = s.fed.exchange(false, std::memory_order_acquire);
+        if (fed)
+            s.offline = false;
+
+        if (s.state == MotorState::OFFLINE && fed)
+        {
+            s.state = MotorState::ONLINE;//重新上线，离线故障自动恢复
+            s.resumed = true;
+            m.output_zero();//从当前位置开始，避免上线瞬间冲向旧目标
+        }
+
+        if (s.state == MotorState::ONLINE)
+        {
+            uint8_t temp = m.get_temp();
+            int16_t cur = m.get_current();
+            int16_t cur_fact = m.get_current_fact();
+
+            if (temp >= limit.temp_max)
+            {
+                enter(s, MotorState::FAULT, ErrorCode::MOTOR_OVER_TEMP, temp);
+                ret = ErrorCode::MOTOR_OVER_TEMP;
+            }
+            else if (std::abs(cur) >= s.cur_sat_raw || std::abs(cur_fact) >= s.cur_sat_raw)
+            {
+                if (++s.sat_ticks >= limit.cur_saturation_ticks)
+                {
+                    enter(s, MotorState::FAULT, ErrorCode::MOTOR_CUR_SATURATED, cur_fact);
+                    ret = ErrorCode::MOTOR_CUR_SATURATED;
+                }
+            }
+            else
+            {
+                s.sat_ticks = 0;
+            }
+        }
+
+        if (s.state != MotorState::ONLINE)
+            m.output_zero();
+    }
+
+public:
+    explicit FaultMonitor(const FaultLimit& limit_ = FaultLimit())
+        : limit(limit_)
+    {
+        epfd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epfd < 0)
+            init_err = ErrorCode::EPOLL_FAILED;
+    }
+
+    ~FaultMonitor()
+    {
+        for (size_t i = 0; i < count; i++)
+            ::close(slots[i].tfd);
+        if (epfd >= 0)
+            ::close(epfd);
+    }
+
+    FaultMonitor(const FaultMonitor&) = delete;
+    FaultMonitor& operator=(const FaultMonitor&) = delete;
+
+    // 构造阶段的错误，epoll创建失败时其余接口都不可用
+    ErrorCode status() const { return init_err; }
+
+    // 可以加入外部epoll统一等待，可读表示有电机心跳超时
+    int fd() const { return epfd; }
+
+    // 注册电机，初始状态为离线，收到第一帧反馈后上线
+    template <typename MotorT>
+    ErrorCode attach(MotorT& motor, size_t* slot_out = nullptr)
+    {
+        using Table = fault_monitor_detail::typed_slots<MotorT, N>;
+        static_assert(fault_monitor_detail::has_table<Table, Tables>::value,
+                      "motor type not listed in FaultMonitor<N, Motors...>");
+        if (init_err != ErrorCode::OK)
+            return init_err;
+        if (count >= N)
+            return ErrorCode::MONITOR_FULL;
+
+        int tfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (tfd < 0)
+            return ErrorCode::TIMERFD_FAILED;
+
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<uint32_t>(count);
+        if (::epoll_ctl(epfd, EPOLL_CTL_ADD, tfd, &ev) < 0)
+        {
+            ::close(tfd);
+            return ErrorCode::EPOLL_FAILED;
+        }
+
+        Table& t = std::get<Table>(tables);
+        t.motor[t.count] = &motor;
+        t.slot[t.count] = count;
+        t.count++;
+
+        Slot& s = slots[count];
+        s.tfd = tfd;
+        s.state = MotorState::OFFLINE;
+        s.offline = true;
+        s.resumed = false;
+        s.fault = FaultInfo();
+        s.fault.motor_id = motor.get_ID();
+        s.motor_id = motor.get_ID();
+        s.fb_can_id = motor.get_fb_can_id();
+        s.cur_sat_raw = static_cast<int>(limit.cur_saturation * MotorT::traits::current_max);
+        s.sat_ticks = 0;
+        if (slot_out)
+            *slot_out = count;
+        count++;
+        return ErrorCode::OK;
+    }
+
+    // 注册电机组里的全部电机，槽位按组内顺序分配
+    template <typename... Ms>
+    ErrorCode attach(MotorGroup<Ms...>& group)
+    {
+        ErrorCode ret = ErrorCode::OK;
+        group.for_each([&](auto& m) {
+            if (ret == ErrorCode::OK)
+                ret = attach(m);
+        });
+        return ret;
+    }
+
+    // can接收线程：收到反馈帧后喂狗，不是已注册电机的帧直接忽略
+    ErrorCode feed(size_t slot)
+    {
+        if (slot >= count)
+            return ErrorCode::MONITOR_BAD_SLOT;
+
+        struct itimerspec its{};
+        its.it_value.tv_sec = limit.heartbeat_ms / 1000;
+        its.it_value.tv_nsec = static_cast<long>(limit.heartbeat_ms % 1000) * 1000000L;
+        // 重新装填会清零到期计数，已到期但未读取的事件随之失效
+        if (::timerfd_settime(slots[slot].tfd, 0, &its, nullptr) < 0)
+            return ErrorCode::TIMERFD_FAILED;
+        slots[slot].fed.store(true, std::memory_order_release);
+        return ErrorCode::OK;
+    }
+
+    ErrorCode on_frame(const struct can_frame& frame)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (slots[i].fb_can_id == frame.can_id)
+                return feed(i);
+        }
+        return ErrorCode::OK;
+    }
+
+    // 控制线程：每个控制周期调用一次，返回本周期新产生的故障(多个时返回最后一个)
+    ErrorCode tick()
+    {
+        if (init_err != ErrorCode::OK)
+            return init_err;
+
+        ErrorCode ret = ErrorCode::OK;
+
+        // 心跳超时
+        struct epoll_event evs[N];
+        int n = ::epoll_wait(epfd, evs, static_cast<int>(N), 0);
+        if (n < 0)
+            ret = ErrorCode::EPOLL_FAILED;
+        for (int i = 0; i < n; i++)
+        {
+            Slot& s = slots[evs[i].data.u32];
+            uint64_t expirations = 0;
+            if (::read(s.tfd, &expirations, sizeof(expirations)) != sizeof(expirations))
+                continue;//期间又收到了反馈，计数已被清零
+            s.offline = true;
+            if (s.state == MotorState::ONLINE)//故障锁存中不覆盖
+            {
+                enter(s, MotorState::OFFLINE, ErrorCode::MOTOR_OFFLINE, static_cast<int32_t>(expirations));
+                ret = ErrorCode::MOTOR_OFFLINE;
+            }
+        }
+
+        for_each_table([&](auto& t) {
+            for (size_t k = 0; k < t.count; k++)
+                check(slots[t.slot[k]], *t.motor[k], ret);
+        });
+
+        return ret;
+    }
+
+    // 清除锁存故障，过温需要先降温；清除时仍在离线的回到OFFLINE，等反馈恢复再上线
+    ErrorCode clear(size_t slot)
+    {
+        if (slot >= count)
+            return ErrorCode::MONITOR_BAD_SLOT;
+
+        Slot& s = slots[slot];
+        if (s.state != MotorState::FAULT)
+            return ErrorCode::OK;
+        uint8_t temp = 0;
+        with_motor(slot, [&](auto& m) { temp = m.get_temp(); });
+        if (s.fault.code == ErrorCode::MOTOR_OVER_TEMP && temp > limit.temp_recover)
+            return ErrorCode::MOTOR_OVER_TEMP;
+
+        if (s.offline)
+            enter(s, MotorState::OFFLINE, ErrorCode::MOTOR_OFFLINE, 0);
+        else
+        {
+            s.state = MotorState::ONLINE;
+            s.resumed = true;
+        }
+        s.sat_ticks = 0;
+        with_motor(slot, [](auto& m) { m.output_zero(); });
+        return ErrorCode::OK;
+    }
+
+    // 控制线程：槽位从离线或故障回到ONLINE后第一次调用返回true，之后返回false
+    bool take_resumed(size_t slot)
+    {
+        if (slot >= count || !slots[slot].resumed)
+            return false;
+        slots[slot].resumed = false;
+        return true;
+    }
+
+    size_t size() const { return count; }
+    MotorState state(size_t slot) const { return slot < count ? slots[slot].state : MotorState::OFFLINE; }
+    FaultInfo fault(size_t slot) const { return slot < count ? slots[slot].fault : FaultInfo(); }
+    bool online(size_t slot) const { return state(slot) == MotorState::ONLINE; }
+};
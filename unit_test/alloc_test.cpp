@@ -0,0 +1,174 @@
+#define ALLOC_AUDIT_HOOKS
+#include "alloc_audit.hpp"
+#include "lubancat_can.hpp"
+#include "can_queue.hpp"
+#include "static_arena.hpp"
+#include "fault_monitor.hpp"
+#include "trajectory.hpp"
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// 稳态循环无堆分配测试：接收 -> 队列 -> 解包 -> 轨迹 -> 控制 -> 故障检测 -> 打包 -> 发送
+// 接收和控制分在两个线程，各自打开Scope，覆盖跨线程的队列交接
+// 如果存在vcan0则同时覆盖真实的接收和发送路径
+
+int main()
+{
+    // 先确认钩子本身有效
+    AllocAudit::fatal = false;
+    {
+        AllocAudit::Scope audit;
+        std::vector<int> v(4);
+        (void)v;
+    }
+    if (AllocAudit::violations.load() != 1)
+    {
+        std::cerr << "alloc hook not installed" << std::endl;
+        return 1;
+    }
+    AllocAudit::violations = 0;
+
+    // 对齐分配也要被检查
+    {
+        AllocAudit::Scope audit;
+        delete new CanFrameQueue<64>;
+    }
+    if (AllocAudit::violations.load() != 1)
+    {
+        std::cerr << "aligned alloc hook not installed" << std::endl;
+        return 1;
+    }
+    AllocAudit::violations = 0;
+
+    // 只检查打开Scope的线程，其它线程分配不计
+    {
+        std::atomic<int> step{0};
+        std::thread other([&] {
+            while (step.load() != 1) {}
+            std::vector<int> v(4);
+            (void)v;
+            step = 2;
+        });
+        {
+            AllocAudit::Scope audit;
+            step = 1;
+            while (step.load() != 2) {}
+        }
+        other.join();
+    }
+    if (AllocAudit::violations.load() != 0)
+    {
+        std::cerr << "alloc audit leaks into other threads" << std::endl;
+        return 1;
+    }
+    AllocAudit::fatal = true;
+
+    // 启动阶段：允许分配
+    PID_para para{1, 0, 0};
+    StaticArena<GM6020, 7> motors;
+    for (uint8_t id = 1; id <= 4; id++)
+    {
+        if (motors.emplace(nullptr, id, para, para, para) != ErrorCode::OK)
+            return 1;
+    }
+
+    TrajLimit lim{8191 * 2, 8191 * 10, 8191 * 200};
+    TrajectoryGenerator<> traj[7];
+    for (size_t i = 0; i < motors.size(); i++)
+    {
+        traj[i].config(ProfileType::S_CURVE, lim);
+        traj[i].reset(0);
+    }
+
+    CanFrameQueue<64> rx_queue;
+    FaultMonitor<7> monitor;
+    for (auto& m : motors)
+        monitor.attach(m);
+
+    std::unique_ptr<CanSocket> can;
+    try {
+        can.reset(new CanSocket("vcan0"));
+    } catch (const std::exception& e) {
+        std::cout << "vcan0 unavailable, skip socket send/recv: " << e.what() << std::endl;
+    }
+
+    uint16_t fb_ids[7] = {};
+    for (size_t i = 0; i < motors.size(); i++)
+        fb_ids[i] = motors[i].get_fb_can_id();
+
+    // 稳态：任何分配都会abort
+    // 接收线程：读vcan0（不等待），再合成各电机的反馈帧，全部投递到队列，队列满时等控制线程取走
+    std::atomic<bool> produced{false};
+    std::thread receiver([&] {
+        AllocAudit::Scope audit;
+        struct can_frame frame{};
+        for (int tick = 0; tick < 2000; tick++)
+        {
+            while (can && can->recvFrame(frame, 0) == ErrorCode::OK)
+            {
+                while (rx_queue.push(frame) == ErrorCode::QUEUE_FULL) {}
+            }
+            for (size_t i = 0; i < motors.size(); i++)
+            {
+                frame = {};
+                frame.can_id = fb_ids[i];
+                frame.can_dlc = 8;
+                frame.data[0] = (tick >> 8) & 0x1F;
+                frame.data[1] = tick & 0xFF;
+                frame.data[6] = 30;
+                while (rx_queue.push(frame) == ErrorCode::QUEUE_FULL) {}
+            }
+        }
+        produced = true;
+    });
+
+    // 控制线程：接收线程结束且队列取空后退出
+    {
+        AllocAudit::Scope audit;
+        struct can_frame frame{};
+        struct can_frame tx{};
+        for (int tick = 0; !produced.load() || !rx_queue.empty(); tick++)
+        {
+            while (rx_queue.pop(frame) == ErrorCode::OK)
+            {
+                for (auto& m : motors)
+                {
+                    if (m.data_set(frame))
+                        break;
+                }
+                monitor.on_frame(frame);
+            }
+
+            if (tick % 500 == 0)
+            {
+                for (size_t i = 0; i < motors.size(); i++)
+                    traj[i].set_target((tick / 500 % 2) ? 0 : 8191);
+            }
+            for (size_t i = 0; i < motors.size(); i++)
+            {
+                if (monitor.take_resumed(i))//槽位按attach顺序，和motors下标一致
+                    traj[i].reset(motors[i].get_circles_fact());
+                motors[i].set_setpoint(traj[i].step());
+                motors[i].position_cur_trigger();
+            }
+            monitor.tick();
+
+            tx = {};
+            tx.can_id = 0x1FE;
+            tx.can_dlc = 8;
+            for (auto& m : motors)
+                m.can_data_fill(tx);
+            if (can)
+                can->sendFrame(tx);
+        }
+    }
+    receiver.join();
+
+    if (AllocAudit::violations.load() != 0)
+        return 1;
+    std::cout << "alloc_test passed" << std::endl;
+    return 0;
+}
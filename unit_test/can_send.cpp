@@ -47,7 +47,11 @@ int main(int argc, char** argv) {
                     data.push_back(static_cast<uint8_t>(value));
                 }
 
-                can.sendFrame(can_id, data);
+                ErrorCode err = can.sendFrame(can_id, data.data(), data.size());
+                if (err != ErrorCode::OK) {
+                    std::cout << "[TX] 发送失败: " << error_str(err) << std::endl;
+                    continue;
+                }
                 std::cout << "[TX] 发送 CAN 帧: ID=0x" << std::hex << can_id << " DLC=" << std::dec << data.size() << " Data=";
                 for (auto b : data) printf(" %02X", b);
                 std::cout << std::endl;
@@ -57,14 +61,17 @@ int main(int argc, char** argv) {
                 int timeout_ms = 1000;
                 if (iss >> timeout_ms) {}
                 struct can_frame frame;
-                if (can.recvFrame(frame, timeout_ms)) {
+                ErrorCode err = can.recvFrame(frame, timeout_ms);
+                if (err == ErrorCode::OK) {
                     std::cout << "[RX] 接收到 CAN 帧: ID=0x" << std::hex << frame.can_id << std::dec
                               << " DLC=" << int(frame.can_dlc) << " Data:";
                     for (int i = 0; i < frame.can_dlc; ++i)
                         printf(" %02X", frame.data[i]);
                     std::cout << std::endl;
-                } else {
+                } else if (err == ErrorCode::CAN_TIMEOUT) {
                     std::cout << "[RX] 超时（无新帧）" << std::endl;
+                } else {
+                    std::cout << "[RX] 接收失败: " << error_str(err) << std::endl;
                 }
             }
 
@@ -72,7 +79,7 @@ int main(int argc, char** argv) {
                 std::cout << "进入持续监听模式（按 Ctrl+C 退出）..." << std::endl;
                 struct can_frame frame;
                 while (true) {
-                    if (can.recvFrame(frame, 1000)) {
+                    if (can.recvFrame(frame, 1000) == ErrorCode::OK) {
                         std::cout << "[RX] ID=0x" << std::hex << frame.can_id << std::dec
                                   << " DLC=" << int(frame.can_dlc) << " Data:";
                         for (int i = 0; i < frame.can_dlc; ++i)
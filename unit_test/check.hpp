@@ -0,0 +1,16 @@
+/**
+ * 单元测试断言
+ * CHECK失败时打印行号并计数，不中断测试，main结尾按failed返回。
+ */
+#pragma once
+#include <iostream>
+
+static int failed = 0;
+
+#define CHECK(cond)                                                     \
+    do {                                                                \
+        if (!(cond)) {                                                  \
+            std::cerr << "FAILED line " << __LINE__ << ": " #cond << std::endl; \
+            failed++;                                                   \
+        }                                                               \
+    } while (0)
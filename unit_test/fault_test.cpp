@@ -0,0 +1,172 @@
+#include "fault_monitor.hpp"
+#include "check.hpp"
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+// 构造一帧GM6020反馈
+static struct can_frame fb_frame(uint8_t id, int16_t cur, uint8_t temp)
+{
+    struct can_frame f{};
+    f.can_id = 0x204 + id;
+    f.can_dlc = 8;
+    f.data[4] = static_cast<uint16_t>(cur) >> 8;
+    f.data[5] = static_cast<uint16_t>(cur) & 0xFF;
+    f.data[6] = temp;
+    return f;
+}
+
+static void recv(GM6020& m, FaultMonitor<>& mon, const struct can_frame& f)
+{
+    m.data_set(const_cast<struct can_frame&>(f));
+    mon.on_frame(f);
+}
+
+int main()
+{
+    PID_para para{1, 0, 0};
+    GM6020 m1(1, para, para, para);
+    GM6020 m2(2, para, para, para);
+
+    FaultLimit limit;
+    limit.heartbeat_ms = 30;
+    limit.cur_saturation_ticks = 3;
+    FaultMonitor<> mon(limit);
+    CHECK(mon.status() == ErrorCode::OK);
+
+    size_t s1 = 0, s2 = 0;
+    CHECK(mon.attach(m1, &s1) == ErrorCode::OK);
+    CHECK(mon.attach(m2, &s2) == ErrorCode::OK);
+
+    // 未收到反馈：离线且输出为零
+    m1.set_current_RAW(1000);
+    mon.tick();
+    CHECK(mon.state(s1) == MotorState::OFFLINE);
+    CHECK(m1.get_current() == 0);
+
+    // 收到反馈后上线，输出放行
+    recv(m1, mon, fb_frame(1, 0, 30));
+    recv(m2, mon, fb_frame(2, 0, 30));
+    mon.tick();
+    CHECK(mon.online(s1));
+    CHECK(mon.online(s2));
+    m1.set_current_RAW(1000);
+    mon.tick();
+    CHECK(m1.get_current() == 1000);
+
+    // 过温：当个周期内清零并锁存
+    recv(m1, mon, fb_frame(1, 0, 80));
+    m1.set_current_RAW(1000);
+    CHECK(mon.tick() == ErrorCode::MOTOR_OVER_TEMP);
+    CHECK(mon.state(s1) == MotorState::FAULT);
+    CHECK(mon.fault(s1).code == ErrorCode::MOTOR_OVER_TEMP);
+    CHECK(mon.fault(s1).motor_id == 1);
+    CHECK(m1.get_current() == 0);
+    CHECK(mon.clear(s1) == ErrorCode::MOTOR_OVER_TEMP);
+    recv(m1, mon, fb_frame(1, 0, 50));
+    CHECK(mon.clear(s1) == ErrorCode::OK);
+    CHECK(mon.online(s1));
+
+    // 电流饱和：连续N个周期才判定
+    for (int i = 0; i < 2; i++)
+    {
+        m2.set_current_RAW(16384);
+        CHECK(mon.tick() == ErrorCode::OK);
+    }
+    m2.set_current_RAW(16384);
+    CHECK(mon.tick() == ErrorCode::MOTOR_CUR_SATURATED);
+    CHECK(m2.get_current() == 0);
+    CHECK(mon.clear(s2) == ErrorCode::OK);
+
+    // 心跳超时：m1持续喂狗，m2停发
+    for (int i = 0; i < 6; i++)
+    {
+        recv(m1, mon, fb_frame(1, 0, 30));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        mon.tick();
+    }
+    CHECK(mon.online(s1));
+    CHECK(mon.state(s2) == MotorState::OFFLINE);
+    CHECK(mon.fault(s2).code == ErrorCode::MOTOR_OFFLINE);
+
+    // 恢复反馈后自动上线
+    recv(m2, mon, fb_frame(2, 0, 30));
+    mon.tick();
+    CHECK(mon.online(s2));
+
+    // 故障锁存期间心跳超时：保持FAULT和原故障码，反馈恢复也不自动上线
+    recv(m1, mon, fb_frame(1, 0, 80));
+    CHECK(mon.tick() == ErrorCode::MOTOR_OVER_TEMP);
+    for (int i = 0; i < 6; i++)
+    {
+        recv(m2, mon, fb_frame(2, 0, 30));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        mon.tick();
+    }
+    CHECK(mon.state(s1) == MotorState::FAULT);
+    CHECK(mon.fault(s1).code == ErrorCode::MOTOR_OVER_TEMP);
+    recv(m1, mon, fb_frame(1, 0, 65));
+    m1.set_current_RAW(1000);
+    mon.tick();
+    CHECK(mon.state(s1) == MotorState::FAULT);
+    CHECK(mon.fault(s1).code == ErrorCode::MOTOR_OVER_TEMP);
+    CHECK(m1.get_current() == 0);
+    CHECK(mon.clear(s1) == ErrorCode::MOTOR_OVER_TEMP);
+    recv(m1, mon, fb_frame(1, 0, 50));
+    mon.tick();
+    CHECK(mon.clear(s1) == ErrorCode::OK);
+    CHECK(mon.online(s1));
+
+    // 离线时清除故障：回到OFFLINE，反馈恢复后再上线
+    recv(m1, mon, fb_frame(1, 0, 80));
+    mon.tick();
+    for (int i = 0; i < 6; i++)
+    {
+        recv(m2, mon, fb_frame(2, 0, 30));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        mon.tick();
+    }
+    struct can_frame cool = fb_frame(1, 0, 50);
+    m1.data_set(cool);//只更新温度，不喂狗
+    CHECK(mon.clear(s1) == ErrorCode::OK);
+    CHECK(mon.state(s1) == MotorState::OFFLINE);
+    CHECK(mon.fault(s1).code == ErrorCode::MOTOR_OFFLINE);
+    recv(m1, mon, fb_frame(1, 0, 50));
+    mon.tick();
+    CHECK(mon.online(s1));
+
+    // 混用型号：一个监控器，饱和阈值按各自型号的满量程
+    M2006 feeder(3, para, para, para);
+    M3508 wheel(4, para, para, para);
+    MotorGroup group(feeder, wheel);
+    FaultMonitor<4, M2006, M3508> mixed(limit);
+    CHECK(mixed.attach(group) == ErrorCode::OK);
+    CHECK(mixed.size() == 2);
+    struct can_frame f = fb_frame(3, 0, 0);
+    f.can_id = feeder.get_fb_can_id();
+    group.dispatch(f);
+    mixed.on_frame(f);
+    f.can_id = wheel.get_fb_can_id();
+    group.dispatch(f);
+    mixed.on_frame(f);
+    mixed.tick();
+    CHECK(mixed.online(0));
+    CHECK(mixed.online(1));
+    for (int i = 0; i < 3; i++)
+    {
+        feeder.set_current_RAW(M2006Traits::current_max);//对M3508不算饱和
+        wheel.set_current_RAW(M2006Traits::current_max);
+        mixed.tick();
+    }
+    CHECK(mixed.state(0) == MotorState::FAULT);
+    CHECK(mixed.fault(0).code == ErrorCode::MOTOR_CUR_SATURATED);
+    CHECK(mixed.fault(0).motor_id == 3);
+    CHECK(feeder.get_current() == 0);
+    CHECK(mixed.online(1));
+    CHECK(wheel.get_current() == M2006Traits::current_max);
+
+    if (failed)
+        return 1;
+    std::cout << "fault_test passed" << std::endl;
+    return 0;
+}
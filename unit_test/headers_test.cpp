@@ -1,7 +1,14 @@
 #include "lubancat_can.hpp"
 #include "PID.hpp"
+#include "pid_config.hpp"
+#include "trajectory.hpp"
 #include "motor.hpp"
+#include "motor_group.hpp"
 #include "error_struct.hpp"
+#include "fault_monitor.hpp"
+#include "alloc_audit.hpp"
+#include "can_queue.hpp"
+#include "static_arena.hpp"
 
 #include "iostream"
 
@@ -0,0 +1,116 @@
+#include "motor_group.hpp"
+#include "check.hpp"
+#include <iostream>
+
+static struct can_frame fb_frame(uint16_t can_id, uint16_t angle, uint8_t temp)
+{
+    struct can_frame f{};
+    f.can_id = can_id;
+    f.can_dlc = 8;
+    f.data[0] = angle >> 8;
+    f.data[1] = angle & 0xFF;
+    f.data[6] = temp;
+    return f;
+}
+
+static struct can_frame ctl_frame(uint16_t can_id)
+{
+    struct can_frame f{};
+    f.can_id = can_id;
+    f.can_dlc = 8;
+    return f;
+}
+
+int main()
+{
+    PID_para para{0, 0, 0};
+
+    // ID分配
+    GM6020 yaw(1, para, para, para);
+    GM6020 pitch(6, para, para, para);
+    M3508 wheel(2, para, para, para);
+    M2006 feeder(3, para, para, para);
+    CHECK(yaw.get_fb_can_id() == 0x205);
+    CHECK(yaw.get_ctl_can_id_cur() == 0x1FE);
+    CHECK(pitch.get_ctl_can_id_vol() == 0x2FF);
+    CHECK(wheel.get_fb_can_id() == 0x202);
+    CHECK(wheel.get_ctl_can_id_cur() == 0x200);
+    CHECK(feeder.get_fb_can_id() == 0x203);
+
+    bool thrown = false;
+    try {
+        GM6020 bad(8, para, para, para);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // 电流换算按型号
+    wheel.set_current_real(10);
+    CHECK(wheel.get_current() == 8192);
+    feeder.set_current_real(10);
+    CHECK(feeder.get_current() == 10000);
+
+    // 反馈分发
+    MotorGroup group(yaw, pitch, wheel, feeder);
+    CHECK(group.size() == 4);
+    struct can_frame f = fb_frame(0x202, 1000, 40);
+    CHECK(group.dispatch(f));
+    CHECK(wheel.get_angel_fact() == 1000);
+    CHECK(wheel.get_temp() == 40);
+    f = fb_frame(0x203, 2000, 40);
+    CHECK(group.dispatch(f));
+    CHECK(feeder.get_temp() == 0);//M2006没有温度反馈
+    f = fb_frame(0x20C, 0, 0);
+    CHECK(!group.dispatch(f));
+
+    // 多圈累计：逐帧跟踪角度，正反两个方向跨过零点
+    GM6020 turret(2, para, para, para);
+    const uint16_t angles[] = {100, 3000, 6000, 8100, 50, 2000};
+    const int16_t expect[] = {100, 3000, 6000, 8100, 8242, 10192};
+    for (int i = 0; i < 6; i++)
+    {
+        f = fb_frame(turret.get_fb_can_id(), angles[i], 30);
+        turret.data_set(f);
+        CHECK(turret.get_circles_fact() == expect[i]);
+        CHECK(turret.get_angle_last() == angles[i]);
+    }
+    CHECK(turret.get_circle() == 1);
+    f = fb_frame(turret.get_fb_can_id(), 8000, 30);
+    turret.data_set(f);
+    CHECK(turret.get_circles_fact() == 8000);
+    CHECK(turret.get_circle() == 0);
+
+    // 打包：大端，按ID放入对应位置
+    yaw.set_current_RAW(0x1234);
+    wheel.set_current_RAW(-2);
+    feeder.set_current_RAW(0x0102);
+    struct can_frame tx = ctl_frame(0x200);
+    CHECK(group.fill(tx) == 2);
+    CHECK(tx.data[2] == 0xFF && tx.data[3] == 0xFE);
+    CHECK(tx.data[4] == 0x01 && tx.data[5] == 0x02);
+    tx = ctl_frame(0x1FE);
+    CHECK(group.fill(tx) == 1);
+    CHECK(tx.data[0] == 0x12 && tx.data[1] == 0x34);
+    yaw.set_voltage_RAW(0x0A0B);
+    tx = ctl_frame(yaw.get_ctl_can_id_vol());
+    CHECK(yaw.can_data_fill(tx) == 0);
+    CHECK(tx.data[0] == 0x0A && tx.data[1] == 0x0B);
+    tx = ctl_frame(0x1FF);
+    CHECK(wheel.can_data_fill(tx) == -1);//M3508没有电压模式，ID 2不在0x1FF帧里
+
+    // 输出限幅按型号
+    feeder.set_current_RAW(0);
+    feeder.set_setpoint(TrajPoint());
+    feeder.set_ff_acc_gain(1000);
+    TrajPoint sp;
+    sp.acc = 8191 * 100;
+    feeder.set_setpoint(sp);
+    feeder.position_cur_trigger();
+    CHECK(feeder.get_current() == M2006Traits::current_max);
+
+    if (failed)
+        return 1;
+    std::cout << "motor_test passed" << std::endl;
+    return 0;
+}
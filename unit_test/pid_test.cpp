@@ -0,0 +1,185 @@
+#include "pid_config.hpp"
+#include "motor.hpp"
+#include "check.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+static bool parse_throws(const std::string& text)
+{
+    std::istringstream in(text);
+    try {
+        pid_config_parse(in);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    // 基本计算与周期边界生效
+    int16_t sp = 10, fb = 0, out = 0;
+    PIDController<int16_t> pid(&sp, &fb, &out);
+    pid.setKp(2);
+    CHECK(pid.activeParams().Kp == 0);//未到周期边界
+    pid.trriger();
+    CHECK(out == 20);
+    CHECK(pid.activeParams().Kp == 2);
+
+    // 频率不合法时整套丢弃，两个接口规则一致
+    PID_para bad{5, 5, 5};
+    bad.frequency = 0;
+    CHECK(!pid.setParams(bad));
+    CHECK(!pid.setFrequency(-1));
+    CHECK(pid.getKp() == 2);
+    CHECK(pid.getFrequency() == 1000);
+    CHECK(pid.setFrequency(500));
+    pid.trriger();
+    CHECK(pid.activeParams().frequency == 500);
+    CHECK(pid.activeParams().Kp == 2);
+
+    PID_para para{0, 1, 0};
+    para.integral_min = -0.005;
+    para.integral_max = 0.005;
+    para.use_integral_limit = true;
+    pid.setParams(para);
+    for (int i = 0; i < 10; i++)
+        pid.trriger();
+    CHECK(pid.activeParams().integral_max == 0.005);
+    CHECK(std::fabs(pid.activeParams().Ki * 0.005 - 0.005) < 1e-12);
+    CHECK(out == 0);//积分被限在0.005，输出截断为0
+
+    // 积分下限大于上限、非有限数同样整套丢弃
+    CHECK(!pid.setIntegralLimit(1, -1));
+    CHECK(pid.getParams().integral_max == 0.005);
+    CHECK(pid.setIntegralLimit(-1, 1));
+    CHECK(pid.getParams().integral_max == 1);
+    PID_para nan_para{std::nan(""), 0, 0};
+    CHECK(!pid.setParams(nan_para));
+    CHECK(pid.getKp() == 0);
+
+    // 另一个线程持续发布整套参数，控制线程看到的每一套都必须是同一次发布的
+    PID_para start{0, 0, 0};
+    start.use_integral_limit = true;
+    pid.setParams(start);
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        for (int k = 1; !stop.load(); k++)
+        {
+            PID_para p{double(k), double(k), double(k)};
+            p.integral_min = -k;
+            p.integral_max = k;
+            p.use_integral_limit = true;
+            p.frequency = 1000 + k % 7;
+            pid.setParams(p);
+        }
+    });
+    double last = 0;
+    for (int i = 0; i < 200000; i++)
+    {
+        pid.trriger();
+        const PID_para& p = pid.activeParams();
+        CHECK(p.Kp == p.Ki && p.Ki == p.Kd && p.integral_max == p.Kp && p.integral_min == -p.Kp);
+        CHECK(p.frequency == 1000 + static_cast<int>(p.Kp) % 7 || p.Kp == 0);
+        CHECK(p.Kp >= last);
+        last = p.Kp;
+        if (failed)
+            break;
+    }
+    stop = true;
+    writer.join();
+
+    // 配置文件
+    const char* text =
+        "# test\n"
+        "[yaw.position]\n"
+        "Kp = 1.5\n"
+        "Kd = 0.01   # 注释\n"
+        "\n"
+        "[yaw.speed_cur]\n"
+        "Kp = 30\n"
+        "Ki = 2\n"
+        "integral_min = -500\n"
+        "integral_max = 500\n"
+        "frequency = 2000\n";
+    std::istringstream in(text);
+    PidConfig cfg = pid_config_parse(in);
+    CHECK(cfg.size() == 2);
+    CHECK(cfg["yaw.position"].Kp == 1.5);
+    CHECK(cfg["yaw.position"].Kd == 0.01);
+    CHECK(!cfg["yaw.position"].use_integral_limit);
+    CHECK(cfg["yaw.speed_cur"].use_integral_limit);
+    CHECK(cfg["yaw.speed_cur"].integral_min == -500);
+    CHECK(cfg["yaw.speed_cur"].frequency == 2000);
+
+    CHECK(parse_throws("Kp = 1\n"));
+    CHECK(parse_throws("[a]\nKq = 1\n"));
+    CHECK(parse_throws("[a]\nKp = 1x\n"));
+    CHECK(parse_throws("[a\n"));
+    CHECK(parse_throws("[a]\nintegral_min = 1\nintegral_max = -1\n"));
+    CHECK(parse_throws("[a]\nfrequency = 0.5\n"));
+    CHECK(parse_throws("[a]\nfrequency = 1000.5\n"));
+    CHECK(parse_throws("[a]\nfrequency = -1\n"));
+    CHECK(parse_throws("[a]\nKp = 1\n[b]\n[a]\nKi = 1\n"));
+    CHECK(parse_throws("[a]\nKp = nan\n"));
+    CHECK(parse_throws("[a]\nKi = inf\n"));
+    CHECK(parse_throws("[a]\nintegral_max = -INF\n"));
+
+    char path[] = "/tmp/pid_test_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    CHECK(write(fd, text, strlen(text)) == static_cast<ssize_t>(strlen(text)));
+    close(fd);
+    PidConfig loaded = pid_config_load(path);
+    std::remove(path);
+    CHECK(loaded.size() == 2);
+
+    PID_para zero{0, 0, 0};
+    GM6020 yaw(1, zero, zero, zero);
+    CHECK(pid_config_apply(yaw, loaded, "yaw"));
+    CHECK(yaw.getPidParams().position.Kp == 1.5);
+    CHECK(yaw.getPidParams().speed_cur.frequency == 2000);
+    CHECK(yaw.getPidParams().speed_vol.Kp == 0);
+
+    // 串级：三套参数一起发布，控制线程每个周期看到的位置环和速度环参数来自同一次发布
+    MotorPID_para cascade{zero, zero, zero};
+    CHECK(yaw.setPidParams(cascade));
+    std::atomic<bool> stop_cascade{false};
+    std::thread tuner([&] {
+        for (int k = 1; !stop_cascade.load(); k++)
+        {
+            MotorPID_para p{zero, zero, zero};
+            p.position.Kp = k;
+            p.speed_cur.Kp = k;
+            p.speed_cur.frequency = 1000 + k % 7;
+            yaw.setPidParams(p);
+        }
+    });
+    for (int i = 0; i < 200000; i++)
+    {
+        yaw.position_cur_trigger();
+        const MotorPID_para& p = yaw.activePidParams();
+        CHECK(p.position.Kp == p.speed_cur.Kp);
+        CHECK(p.speed_cur.frequency == 1000 + static_cast<int>(p.position.Kp) % 7 || p.position.Kp == 0);
+        if (failed)
+            break;
+    }
+    stop_cascade = true;
+    tuner.join();
+    PID_para bad_limit = zero;
+    bad_limit.use_integral_limit = true;
+    bad_limit.integral_min = 1;
+    CHECK(!yaw.setPidParams(MotorPID_para{zero, bad_limit, zero}));
+
+    if (failed)
+        return 1;
+    std::cout << "pid_test passed" << std::endl;
+    return 0;
+}
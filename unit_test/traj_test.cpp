@@ -0,0 +1,144 @@
+#include "trajectory.hpp"
+#include "check.hpp"
+#include "motor.hpp"
+#include "fault_monitor.hpp"
+#include <iostream>
+#include <cmath>
+
+// 跑到done，检查速度加速度不超限，返回周期数
+template <size_t W>
+static int run(TrajectoryGenerator<W>& traj, const TrajLimit& lim, double jerk_bound, int max_ticks)
+{
+    const double dt = 1.0 / 1000;
+    const double eps = 1e-6;
+    double acc_last = traj.point().acc;
+    int ticks = 0;
+    while (!traj.done() && ticks < max_ticks)
+    {
+        const TrajPoint& sp = traj.step();
+        CHECK(std::fabs(sp.vel) <= lim.v_max + eps);
+        CHECK(std::fabs(sp.acc) <= lim.a_max * (1 + eps));
+        if (jerk_bound > 0)
+            CHECK(std::fabs(sp.acc - acc_last) / dt <= jerk_bound * (1 + eps));
+        acc_last = sp.acc;
+        ticks++;
+    }
+    return ticks;
+}
+
+int main()
+{
+    TrajLimit lim;
+    lim.v_max = 8191 * 2;     //2圈/s
+    lim.a_max = 8191 * 10;
+    lim.j_max = 8191 * 200;
+
+    // 梯形：到达目标，时间接近理论值
+    TrajectoryGenerator<> trap;
+    trap.config(ProfileType::TRAPEZOID, lim);
+    trap.reset(0);
+    trap.set_target(8191 * 3);
+    int ticks = run(trap, lim, 0, 10000);
+    CHECK(trap.done());
+    CHECK(trap.point().pos == 8191 * 3);
+    CHECK(trap.point().vel == 0);
+    // 理论 3/2 + 2/10 = 1.7s
+    CHECK(std::abs(ticks - 1700) < 20);
+
+    // 反向短行程，达不到最大速度
+    trap.set_target(8191 * 3 - 100);
+    run(trap, lim, 0, 10000);
+    CHECK(trap.point().pos == 8191 * 3 - 100);
+
+    // S曲线：加加速度受限
+    TrajectoryGenerator<> scurve;
+    scurve.config(ProfileType::S_CURVE, lim);
+    CHECK(scurve.window_len() == 50);
+    scurve.reset(1000);
+    scurve.set_target(-8191 * 2);
+    run(scurve, lim, lim.j_max, 10000);
+    CHECK(scurve.done());
+    CHECK(scurve.point().pos == -8191 * 2);
+
+    // 运动中改目标：速度连续
+    scurve.set_target(8191 * 2);
+    for (int i = 0; i < 500; i++)
+        scurve.step();
+    double vel_before = scurve.point().vel;
+    scurve.set_target(0);
+    scurve.step();
+    CHECK(std::fabs(scurve.point().vel - vel_before) <= lim.a_max / 1000 + 1e-6);
+    run(scurve, lim, 2 * lim.j_max, 10000);
+    CHECK(scurve.point().pos == 0);
+
+    // 写入电机设定点与前馈
+    PID_para para{0, 0, 0};
+    GM6020 m(1, para, para, para);
+    m.set_ff_acc_gain(2);
+    TrajPoint sp;
+    sp.pos = 1234.4;
+    sp.vel = 8191;
+    sp.acc = 8191;
+    m.set_setpoint(sp);
+    CHECK(m.get_circles() == 1234);
+    CHECK(m.get_rpm_ff() == 60);
+    CHECK(m.get_current_ff() == 120);
+    m.position_cur_trigger();
+    CHECK(m.get_rpm() == 60);
+    CHECK(m.get_current() == 120);
+
+    // 超出int16范围的位置设定点限幅，不回绕
+    sp = TrajPoint();
+    sp.pos = 8191 * 5;
+    m.set_setpoint(sp);
+    CHECK(m.get_circles() == 32767);
+    sp.pos = -8191 * 5;
+    m.set_setpoint(sp);
+    CHECK(m.get_circles() == -32767);
+
+    // 故障恢复：监控器报告重新上线，轨迹从电机当前位置重新开始
+    GM6020 g(3, para, para, para);
+    FaultMonitor<> mon;
+    size_t slot = 0;
+    CHECK(mon.attach(g, &slot) == ErrorCode::OK);
+    struct can_frame fb{};
+    fb.can_id = g.get_fb_can_id();
+    fb.can_dlc = 8;
+    fb.data[0] = 1000 >> 8;
+    fb.data[1] = 1000 & 0xFF;
+    fb.data[6] = 30;
+    g.data_set(fb);
+    mon.on_frame(fb);
+    mon.tick();
+    CHECK(mon.take_resumed(slot));
+    CHECK(!mon.take_resumed(slot));
+
+    TrajectoryGenerator<> follow;
+    follow.config(ProfileType::TRAPEZOID, lim);
+    follow.reset(g.get_circles_fact());
+    follow.set_target(8191 * 3);
+    for (int i = 0; i < 300; i++)
+        g.set_setpoint(follow.step());
+    CHECK(g.get_circles() > 3000);
+
+    fb.data[6] = 80;
+    g.data_set(fb);
+    mon.on_frame(fb);
+    CHECK(mon.tick() == ErrorCode::MOTOR_OVER_TEMP);
+    CHECK(!mon.take_resumed(slot));
+    CHECK(g.get_circles() == 1000);
+    fb.data[6] = 50;
+    g.data_set(fb);
+    mon.on_frame(fb);
+    CHECK(mon.clear(slot) == ErrorCode::OK);
+    CHECK(mon.take_resumed(slot));
+    follow.reset(g.get_circles_fact());
+    g.set_setpoint(follow.step());
+    CHECK(g.get_circles() == 1000);
+    CHECK(g.get_rpm_ff() == 0);
+
+    if (failed)
+        return 1;
+    std::cout << "traj_test passed" << std::endl;
+    return 0;
+}